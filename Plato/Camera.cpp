@@ -60,6 +60,35 @@ Vector3d Camera::WorldSpaceToCameraSpace(const Vector3d& worldSpacePoint) const
 	return transform->GetGlobalRotation().Inverse() * (worldSpacePoint - transform->GetGlobalPosition());
 }
 
+Matrix4x4 Camera::GetWorldSpaceToCameraSpaceMatrix() const
+{
+	const Quaternion inverseRotation = transform->GetGlobalRotation().Inverse();
+	const Vector3d position = transform->GetGlobalPosition();
+
+	// The rotation is linear, so its columns are just the rotated basis vectors
+	const Vector3d columns[3] = {
+		inverseRotation * Vector3d::right,
+		inverseRotation * Vector3d::up,
+		inverseRotation * Vector3d::forward
+	};
+
+	Matrix4x4 m;
+	for (std::size_t i = 0; i < 3; i++)
+	{
+		m[0][i] = columns[i].x;
+		m[1][i] = columns[i].y;
+		m[2][i] = columns[i].z;
+	}
+
+	// Translate by -position first, then rotate. Rotating the translation does the same in one go.
+	const Vector3d translation = inverseRotation * (position * -1);
+	m[0][3] = translation.x;
+	m[1][3] = translation.y;
+	m[2][3] = translation.z;
+
+	return m;
+}
+
 Camera* Camera::GetMainCamera()
 {
 	return mainCamera;
@@ -43,6 +43,10 @@ namespace Plato
 			//! Will transform a world-space point to a camera-space point.
 			Vector3d WorldSpaceToCameraSpace(const Vector3d& worldSpacePoint) const;
 
+			//! Will return a matrix doing the same as WorldSpaceToCameraSpace(), when multiplying a point with it.
+			//! Much cheaper than WorldSpaceToCameraSpace() for a lot of points, as the quaternion math only happens once.
+			Matrix4x4 GetWorldSpaceToCameraSpaceMatrix() const;
+
 			//! Will return the current main camera
 			static Camera* GetMainCamera();
 
@@ -1,5 +1,6 @@
 #include "LightSource.h"
 #include "Renderer.h"
+#include <limits>
 
 using namespace Plato;
 using namespace Plato::Components;
@@ -7,7 +8,8 @@ using namespace TorGL;
 
 LightSource::LightSource(WorldObject* worldObject, double intensity, const Color& color) :
 	Component(worldObject),
-	tornadoLightSource { nullptr }
+	tornadoLightSource { nullptr },
+	cullDistance { std::numeric_limits<double>::infinity() }
 {
 
 	return;
@@ -73,6 +75,17 @@ const std::vector<Collider*>& LightSource::GetDomains() const
 	return lightDomains;
 }
 
+void LightSource::SetCullDistance(double cullDistance)
+{
+	this->cullDistance = cullDistance;
+	return;
+}
+
+double LightSource::GetCullDistance() const
+{
+	return cullDistance;
+}
+
 void LightSource::LateUpdate(double frameTime)
 {
 	// Update light source camera space position
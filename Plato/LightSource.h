@@ -50,6 +50,12 @@ namespace Plato
 			//! Domains are Collider objects that will restrict where the light will be rendered.
 			const std::vector<Collider*>& GetDomains() const;
 
+			//! Will set the distance to the camera, beyond which this light source gets culled. Infinity by default.
+			void SetCullDistance(double cullDistance);
+
+			//! Will return the distance to the camera, beyond which this light source gets culled
+			double GetCullDistance() const;
+
 			//! Will return the tornado render light source. This does NOT include transformation!
 			virtual TorGL::RenderLightSource* GetRawTornadoRenderLightSource() const = 0;
 
@@ -64,6 +70,7 @@ namespace Plato
 			void Render(Renderer* renderer) override;
 
 			std::vector<Collider*> lightDomains;
+			double cullDistance;
 
 		};
 	}
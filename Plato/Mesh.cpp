@@ -1 +1,252 @@
-#include "Mesh.h"
\ No newline at end of file
+#include "Mesh.h"
+#include "MeshSimplifier.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <unordered_map>
+
+using namespace Plato;
+
+namespace {
+	// To find corners using the same position, uv and normal
+	struct CornerHash
+	{
+		std::size_t operator()(const MeshVertexIndices& corner) const
+		{
+			return ((std::size_t)corner.v * 73856093) ^ ((std::size_t)corner.uv * 19349663) ^ ((std::size_t)corner.vn * 83492791);
+		}
+	};
+
+	struct CornerEqual
+	{
+		bool operator()(const MeshVertexIndices& a, const MeshVertexIndices& b) const
+		{
+			return (a.v == b.v) && (a.uv == b.uv) && (a.vn == b.vn);
+		}
+	};
+
+	using CornerMap = std::unordered_map<MeshVertexIndices, std::uint32_t, CornerHash, CornerEqual>;
+
+	template <typename T>
+	T GetOrDefault(const std::vector<T>& source, std::size_t index)
+	{
+		return (index < source.size()) ? source[index] : T();
+	}
+
+	// Shared by all meshes, so that no two ever report the same version
+	std::atomic<std::uint64_t> nextVersion = 1;
+}
+
+Mesh::Version::Version()
+{
+	value = nextVersion++;
+	return;
+}
+
+Mesh::Version::Version(const Version&)
+{
+	value = nextVersion++;
+	return;
+}
+
+Mesh::Version& Mesh::Version::operator=(const Version&)
+{
+	value = nextVersion++;
+	return *this;
+}
+
+void Mesh::RecalculateBounds()
+{
+	MarkModified();
+	hasBounds = false;
+
+	if (v_vertices.empty())
+		return;
+
+	// Find the axis aligned bounding box
+	boundsMin = v_vertices[0];
+	boundsMax = v_vertices[0];
+
+	for (const Vector3d& v : v_vertices)
+	{
+		boundsMin.x = std::min(boundsMin.x, v.x);
+		boundsMin.y = std::min(boundsMin.y, v.y);
+		boundsMin.z = std::min(boundsMin.z, v.z);
+		boundsMax.x = std::max(boundsMax.x, v.x);
+		boundsMax.y = std::max(boundsMax.y, v.y);
+		boundsMax.z = std::max(boundsMax.z, v.z);
+	}
+
+	// The sphere is centered on the box, but only reaches out to the farthest vertex, instead of the boxes corners
+	boundingSphereCenter = (boundsMin + boundsMax) * 0.5;
+
+	double sqrRadius = 0;
+	for (const Vector3d& v : v_vertices)
+		sqrRadius = std::max(sqrRadius, (v - boundingSphereCenter).SqrMagnitude());
+
+	boundingSphereRadius = sqrt(sqrRadius);
+	hasBounds = true;
+
+	return;
+}
+
+void Mesh::MarkModified()
+{
+	version.value = nextVersion++;
+	return;
+}
+
+std::uint64_t Mesh::GetVersion() const
+{
+	return version.value;
+}
+
+void Mesh::SetTriangleMaterials(const std::vector<const Material*>& triangleMaterials)
+{
+	const std::size_t numTriangles = tris.size() / 3;
+
+	// Number materials by their first appearance. Sorting by address would depend on where they live in memory.
+	std::vector<std::size_t> materialIndices(numTriangles);
+	std::vector<const Material*> materials;
+	std::unordered_map<const Material*, std::size_t> materialNumbers;
+	for (std::size_t t = 0; t < numTriangles; t++)
+	{
+		const Material* material = (t < triangleMaterials.size()) ? triangleMaterials[t] : nullptr;
+		const auto [found, isNew] = materialNumbers.emplace(material, materials.size());
+
+		materialIndices[t] = found->second;
+		if (isNew)
+			materials.push_back(material);
+	}
+
+	// Sort the triangles by material
+	std::vector<std::size_t> order(numTriangles);
+	for (std::size_t t = 0; t < numTriangles; t++)
+		order[t] = t;
+
+	std::stable_sort(order.begin(), order.end(),
+		[&materialIndices](std::size_t a, std::size_t b)
+		{
+			return materialIndices[a] < materialIndices[b];
+		}
+	);
+
+	std::vector<MeshVertexIndices> sortedTris(tris.size());
+	for (std::size_t t = 0; t < numTriangles; t++)
+	{
+		sortedTris[t*3]     = tris[order[t]*3];
+		sortedTris[t*3 + 1] = tris[order[t]*3 + 1];
+		sortedTris[t*3 + 2] = tris[order[t]*3 + 2];
+	}
+	tris = std::move(sortedTris);
+
+	// One range per material. A mesh entirely using the mesh renderers material needs none.
+	submeshes.clear();
+	for (std::size_t t = 0; t < numTriangles; t++)
+	{
+		const Material* material = materials[materialIndices[order[t]]];
+
+		if ((!submeshes.empty()) && (submeshes.back().material == material))
+			submeshes.back().end = t + 1;
+		else
+			submeshes.push_back({ t, t + 1, material });
+	}
+
+	if ((submeshes.size() == 1) && (submeshes[0].material == nullptr))
+		submeshes.clear();
+
+	return;
+}
+
+std::vector<const Material*> Mesh::GetTriangleMaterials() const
+{
+	std::vector<const Material*> triangleMaterials(tris.size() / 3, nullptr);
+
+	for (const MeshSubmesh& submesh : submeshes)
+		for (std::size_t t = submesh.begin; (t < submesh.end) && (t < triangleMaterials.size()); t++)
+			triangleMaterials[t] = submesh.material;
+
+	return triangleMaterials;
+}
+
+std::size_t Mesh::CountUniqueVertices() const
+{
+	CornerMap uniqueCorners;
+	uniqueCorners.reserve(tris.size());
+
+	for (const MeshVertexIndices& corner : tris)
+		uniqueCorners.emplace(corner, 0);
+
+	return uniqueCorners.size();
+}
+
+void Mesh::UnifyVertices()
+{
+	CornerMap uniqueCorners;
+	uniqueCorners.reserve(tris.size());
+
+	std::vector<Vector3d> unifiedPositions;
+	std::vector<Vector2d> unifiedUvs;
+	std::vector<Vector3d> unifiedNormals;
+	std::vector<MeshVertexIndices> unifiedTris;
+	unifiedTris.reserve(tris.size());
+
+	for (const MeshVertexIndices& corner : tris)
+	{
+		const auto [found, isNew] = uniqueCorners.emplace(corner, (std::uint32_t)unifiedPositions.size());
+
+		if (isNew)
+		{
+			// The new vertex would not be addressable by MeshVertexIndices. Leave the mesh as it is.
+			if (unifiedPositions.size() > std::numeric_limits<std::uint32_t>::max())
+			{
+				std::cerr << "[WARNING] [Mesh]: Unified vertices would not fit 32 bit indices! Keeping the separate vertex buffers!" << std::endl;
+				return;
+			}
+
+			unifiedPositions.push_back(GetOrDefault(v_vertices, corner.v));
+			unifiedUvs.push_back(GetOrDefault(uv_vertices, corner.uv));
+			unifiedNormals.push_back(GetOrDefault(normals, corner.vn));
+		}
+
+		unifiedTris.push_back({ found->second, found->second, found->second });
+	}
+
+	tris = std::move(unifiedTris);
+	v_vertices = std::move(unifiedPositions);
+	uv_vertices = std::move(unifiedUvs);
+	normals = std::move(unifiedNormals);
+	MarkModified();
+
+	// These refer to the old vertices
+	bvh.Clear();
+	pvs.Clear();
+	lods.clear();
+
+	return;
+}
+
+void Mesh::BuildBVH(std::size_t maxTrianglesPerLeaf)
+{
+	bvh.Build(v_vertices, tris, maxTrianglesPerLeaf);
+	pvs.Clear(); // Refers to the old nodes
+	MarkModified(); // Renderers might have collected triangles from the old nodes
+	return;
+}
+
+void Mesh::BuildPVS(TorGL::WorkerPool& workerPool, std::size_t cellsAlongLongestAxis, std::size_t raysPerNode)
+{
+	if (bvh.Empty())
+		BuildBVH();
+
+	pvs.Build(v_vertices, bvh, workerPool, cellsAlongLongestAxis, raysPerNode);
+	return;
+}
+
+void Mesh::GenerateLods(std::size_t numLods, double reduction)
+{
+	lods = MeshSimplifier::GenerateLods(*this, numLods, reduction);
+	return;
+}
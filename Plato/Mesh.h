@@ -1,23 +1,22 @@
 #pragma once
 #include "Vector.h"
 #include "Material.h"
+#include "MeshBVH.h"
+#include "MeshPVS.h"
+#include "../Tornado/RenderMesh3D.h"
 #include <vector>
-#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
 
 namespace Plato
 {
 	//! This struct holds indices for all important vertex types.
-	struct MeshVertexIndices
-	{
-		//! Index of the 3D world vertex
-		std::size_t v;
-
-		// Index of the uv (texture space) vertex
-		std::size_t uv;
+	//! Same as tornados, so that meshes can be handed to it without converting their indices.
+	using MeshVertexIndices = TorGL::RenderVertexIndices;
 
-		// Index of the normal value
-		std::size_t vn;
-	};
+	//! A contiguous range of triangles sharing a material.
+	//! Same as tornados, so that meshes can be handed to it without converting their material ranges.
+	using MeshSubmesh = TorGL::RenderSubmesh;
 
 	/** 3D mesh representation.
 	*/
@@ -27,7 +26,92 @@ namespace Plato
 		std::vector<Vector2d> uv_vertices;
 		std::vector<Vector3d> normals;
 		std::vector<MeshVertexIndices> tris;
-        std::unordered_map<std::size_t, Material*> trisMaterialIndices;
+
+		//! Ascending ranges of triangles (not tris indices) sharing a material.
+		//! Triangles not covered by any range, and ranges with a nullptr material, use the mesh renderers material.
+		std::vector<MeshSubmesh> submeshes;
+
+		//! Will sort the triangles by material, and rebuild submeshes from that.
+		//! triangleMaterials holds one material per triangle, nullptr for the mesh renderers material.
+		//! Materials keep the order they first appear in, and so do the triangles sharing one.
+		//! Call this before building the bvh, pvs or levels of detail, as it reorders tris.
+		void SetTriangleMaterials(const std::vector<const Material*>& triangleMaterials);
+
+		//! Will return one material per triangle, as defined by submeshes. nullptr for the mesh renderers material.
+		std::vector<const Material*> GetTriangleMaterials() const;
+
+		//! Will return how many unique combinations of position, uv and normal the triangles use.
+		//! This is how many vertices UnifyVertices() would result in.
+		std::size_t CountUniqueVertices() const;
+
+		//! Will merge the three vertex buffers into one, with a vertex per unique combination of position, uv and normal.
+		//! Afterwards, v_vertices, uv_vertices and normals are equally long, every corners v, uv and vn are the same,
+		//! and vertices are stored in the order the triangles first use them. Unused vertices get dropped.
+		//! Makes fetching vertices much more cache friendly, but every vertex then has its own normal to resolve. See CountUniqueVertices().
+		//! Leaves the mesh unchanged, with a warning, if there would be more vertices than 32 bit indices can address.
+		//! Removes the bvh, pvs and levels of detail, as they refer to the old vertices.
+		void UnifyVertices();
+
+		//! Will recalculate the bounding volumes from v_vertices.
+		//! Call this after modifying the vertices, or the renderer might cull the mesh based on stale bounds. Calls MarkModified().
+		void RecalculateBounds();
+
+		//! Will make renderers drop whatever they have resolved from this mesh, like transformed vertices.
+		//! Call this after modifying v_vertices, uv_vertices or normals in place. The member functions modifying them already do.
+		void MarkModified();
+
+		//! Will return a number that changes with every call to MarkModified(). No two meshes ever have the same one, not even copies.
+		std::uint64_t GetVersion() const;
+
+		//! Axis aligned bounding box in object space
+		Vector3d boundsMin;
+		Vector3d boundsMax;
+
+		//! Bounding sphere in object space
+		Vector3d boundingSphereCenter;
+		double boundingSphereRadius = 0;
+
+		//! Whether the bounding volumes have been calculated. Meshes without bounds never get culled.
+		bool hasBounds = false;
+
+		//! Will (re)build the bounding volume hierarchy over tris.
+		//! Worth it for big meshes, like whole levels, of which usually only a fraction is in view.
+		//! Call this again after modifying the vertices or tris. Calls MarkModified().
+		void BuildBVH(std::size_t maxTrianglesPerLeaf = 256);
+
+		//! Optional bounding volume hierarchy over tris. Empty, if not built.
+		//! If present, the renderer only draws the triangles of nodes in view.
+		MeshBVH bvh;
+
+		//! Will (re)compute the potentially visible set of the bvh nodes. Builds the bvh first, if there is none.
+		//! Expensive! Meant for static level geometry. See MeshPVS, and ResourceManager::LoadMeshFromObj() for caching it.
+		//! Runs on workerPool, see MeshPVS::Build().
+		void BuildPVS(TorGL::WorkerPool& workerPool, std::size_t cellsAlongLongestAxis = 16, std::size_t raysPerNode = 32);
+
+		//! Optional potentially visible set of the bvh nodes. Empty, if not built.
+		//! If present, and the camera is within the meshes bounds, the renderer skips all nodes not visible from the cameras cell.
+		MeshPVS pvs;
+
+		//! Will (re)generate the levels of detail. Each one has about reduction times the triangles of the one before.
+		//! See MeshSimplifier. Call this again after modifying the mesh.
+		void GenerateLods(std::size_t numLods = 3, double reduction = 0.5);
+
+		//! Optional simplified versions of this mesh, from fine to coarse. Empty, if not generated.
+		//! Mesh renderers pick one of these each frame, depending on how big the mesh is on screen.
+		std::vector<Mesh> lods;
+
+	private:
+		//! Draws a new version whenever it gets constructed, copied or assigned, so that copying a mesh never copies its version
+		struct Version
+		{
+			Version();
+			Version(const Version& other);
+			Version& operator=(const Version& other);
+
+			std::uint64_t value;
+		};
+
+		Version version;
 	};
 }
 
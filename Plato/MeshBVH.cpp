@@ -0,0 +1,137 @@
+#include "MeshBVH.h"
+#include <algorithm>
+
+using namespace Plato;
+
+void MeshBVH::Build(const std::vector<Vector3d>& vertices, const std::vector<TorGL::RenderVertexIndices>& tris, std::size_t maxTrianglesPerLeaf)
+{
+	Clear();
+
+	const std::size_t numTriangles = tris.size() / 3;
+	if (numTriangles == 0)
+		return;
+
+	// Triangles get sorted by their centroids
+	std::vector<Vector3d> centroids(numTriangles);
+	for (std::size_t i = 0; i < numTriangles; i++)
+		centroids[i] = (vertices[tris[i*3].v] + vertices[tris[i*3 + 1].v] + vertices[tris[i*3 + 2].v]) / 3.0;
+
+	triangleOrder.resize(numTriangles);
+	for (std::size_t i = 0; i < numTriangles; i++)
+		triangleOrder[i] = i;
+
+	// About two nodes per leaf
+	nodes.reserve((numTriangles / std::max<std::size_t>(maxTrianglesPerLeaf, 1) + 1) * 2);
+
+	BuildNode(0, numTriangles, std::max<std::size_t>(maxTrianglesPerLeaf, 1), centroids, vertices, tris);
+
+	// Put the vertex indices in bvh order
+	orderedTris.resize(tris.size());
+	for (std::size_t i = 0; i < numTriangles; i++)
+	{
+		orderedTris[i*3]     = tris[triangleOrder[i]*3];
+		orderedTris[i*3 + 1] = tris[triangleOrder[i]*3 + 1];
+		orderedTris[i*3 + 2] = tris[triangleOrder[i]*3 + 2];
+	}
+
+	return;
+}
+
+void MeshBVH::BuildNode(std::size_t begin, std::size_t end, std::size_t maxTrianglesPerLeaf, const std::vector<Vector3d>& centroids, const std::vector<Vector3d>& vertices, const std::vector<TorGL::RenderVertexIndices>& tris)
+{
+	const std::size_t nodeIndex = nodes.size();
+	nodes.emplace_back();
+
+	// Find the bounds of all vertices, and of all centroids
+	Vector3d boundsMin = vertices[tris[triangleOrder[begin]*3].v];
+	Vector3d boundsMax = boundsMin;
+	Vector3d centroidsMin = centroids[triangleOrder[begin]];
+	Vector3d centroidsMax = centroidsMin;
+
+	for (std::size_t i = begin; i < end; i++)
+	{
+		for (std::size_t j = 0; j < 3; j++)
+		{
+			const Vector3d& v = vertices[tris[triangleOrder[i]*3 + j].v];
+			boundsMin.x = std::min(boundsMin.x, v.x);
+			boundsMin.y = std::min(boundsMin.y, v.y);
+			boundsMin.z = std::min(boundsMin.z, v.z);
+			boundsMax.x = std::max(boundsMax.x, v.x);
+			boundsMax.y = std::max(boundsMax.y, v.y);
+			boundsMax.z = std::max(boundsMax.z, v.z);
+		}
+
+		const Vector3d& c = centroids[triangleOrder[i]];
+		centroidsMin.x = std::min(centroidsMin.x, c.x);
+		centroidsMin.y = std::min(centroidsMin.y, c.y);
+		centroidsMin.z = std::min(centroidsMin.z, c.z);
+		centroidsMax.x = std::max(centroidsMax.x, c.x);
+		centroidsMax.y = std::max(centroidsMax.y, c.y);
+		centroidsMax.z = std::max(centroidsMax.z, c.z);
+	}
+
+	nodes[nodeIndex].boundsMin = boundsMin;
+	nodes[nodeIndex].boundsMax = boundsMax;
+	nodes[nodeIndex].begin = begin;
+	nodes[nodeIndex].end = end;
+
+	// Split at the median centroid along the longest axis. Stop, if small enough, or all centroids coincide.
+	const Vector3d extent = centroidsMax - centroidsMin;
+	const std::size_t axis = ((extent.x >= extent.y) && (extent.x >= extent.z)) ? 0 : (extent.y >= extent.z) ? 1 : 2;
+
+	if ((end - begin > maxTrianglesPerLeaf) && (extent[axis] > 0))
+	{
+		const std::size_t mid = begin + (end - begin) / 2;
+
+		std::nth_element(
+			triangleOrder.begin() + begin,
+			triangleOrder.begin() + mid,
+			triangleOrder.begin() + end,
+			[&centroids, axis](std::size_t a, std::size_t b)
+			{
+				return centroids[a][axis] < centroids[b][axis];
+			}
+		);
+
+		BuildNode(begin, mid, maxTrianglesPerLeaf, centroids, vertices, tris);
+		BuildNode(mid, end, maxTrianglesPerLeaf, centroids, vertices, tris);
+	}
+	else
+	{
+		// Leaves keep the original triangle order. Triangles sharing a material stay together that way.
+		std::sort(triangleOrder.begin() + begin, triangleOrder.begin() + end);
+	}
+
+	nodes[nodeIndex].skip = nodes.size();
+
+	return;
+}
+
+void MeshBVH::Clear()
+{
+	nodes.clear();
+	orderedTris.clear();
+	triangleOrder.clear();
+
+	return;
+}
+
+bool MeshBVH::Empty() const
+{
+	return nodes.empty();
+}
+
+const std::vector<MeshBVH::Node>& MeshBVH::GetNodes() const
+{
+	return nodes;
+}
+
+const std::vector<TorGL::RenderVertexIndices>& MeshBVH::GetTris() const
+{
+	return orderedTris;
+}
+
+const std::vector<std::size_t>& MeshBVH::GetTriangleOrder() const
+{
+	return triangleOrder;
+}
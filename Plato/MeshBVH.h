@@ -0,0 +1,58 @@
+#pragma once
+#include "Vector.h"
+#include "../Tornado/RenderMesh3D.h"
+#include <vector>
+#include <cstddef>
+
+namespace Plato
+{
+	/** Bounding volume hierarchy over the triangles of a single mesh.
+	* Triangles get reordered, so that every node covers a contiguous range of them. Within a leaf, they keep their original order.
+	* Nodes are stored depth first. Skipping a node (and all its children) means jumping to its skip index.
+	*/
+	class MeshBVH
+	{
+	public:
+		struct Node
+		{
+			//! Axis aligned bounding box in object space, enclosing all triangles of this node
+			Vector3d boundsMin;
+			Vector3d boundsMax;
+
+			//! Range of triangles (in bvh order) covered by this node
+			std::size_t begin;
+			std::size_t end;
+
+			//! Index of the next node not being a child of this node. Equals numNodes for the last subtree.
+			std::size_t skip;
+		};
+
+		//! Will build the hierarchy over a meshes triangles.
+		//! tris has three vertex indices per triangle, just like Mesh::tris.
+		//! Nodes with maxTrianglesPerLeaf triangles or less do not get split any further.
+		void Build(const std::vector<Vector3d>& vertices, const std::vector<TorGL::RenderVertexIndices>& tris, std::size_t maxTrianglesPerLeaf = 256);
+
+		//! Will remove the hierarchy
+		void Clear();
+
+		//! Will return whether there is no hierarchy
+		bool Empty() const;
+
+		//! Will return all nodes, depth first. The root is the first node.
+		const std::vector<Node>& GetNodes() const;
+
+		//! Will return the triangles vertex indices in bvh order. Three per triangle.
+		const std::vector<TorGL::RenderVertexIndices>& GetTris() const;
+
+		//! Will return the original triangle index for each triangle in bvh order
+		const std::vector<std::size_t>& GetTriangleOrder() const;
+
+	private:
+		//! Will create the node for the triangles [begin, end) of triangleOrder, and recurse into its children
+		void BuildNode(std::size_t begin, std::size_t end, std::size_t maxTrianglesPerLeaf, const std::vector<Vector3d>& centroids, const std::vector<Vector3d>& vertices, const std::vector<TorGL::RenderVertexIndices>& tris);
+
+		std::vector<Node> nodes;
+		std::vector<TorGL::RenderVertexIndices> orderedTris;
+		std::vector<std::size_t> triangleOrder;
+	};
+}
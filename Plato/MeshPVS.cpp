@@ -0,0 +1,398 @@
+#include "MeshPVS.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <random>
+#include <cstring>
+
+using namespace Plato;
+
+namespace {
+	// Identifies pvs cache files, and their format version
+	constexpr char fileMagic[8] = { 'P', 'L', 'A', 'T', 'O', 'P', 'V', 'S' };
+	constexpr std::uint32_t fileVersion = 2;
+
+	// Leaves whose bounds come within this many cells of a cell always count as visible from it, without casting any rays
+	constexpr double nearbyMarginInCells = 1.0;
+
+	// Will return whether the segment from + dir * [0, 1] touches the box
+	bool SegmentHitsBox(const Vector3d& from, const Vector3d& dir, const Vector3d& boundsMin, const Vector3d& boundsMax)
+	{
+		double tMin = 0;
+		double tMax = 1;
+
+		for (std::size_t a = 0; a < 3; a++)
+		{
+			// Parallel to this slab
+			if (std::abs(dir[a]) < 1e-12)
+			{
+				if ((from[a] < boundsMin[a]) || (from[a] > boundsMax[a]))
+					return false;
+
+				continue;
+			}
+
+			const double invDir = 1.0 / dir[a];
+			double t0 = (boundsMin[a] - from[a]) * invDir;
+			double t1 = (boundsMax[a] - from[a]) * invDir;
+			if (t0 > t1)
+				std::swap(t0, t1);
+
+			tMin = std::max(tMin, t0);
+			tMax = std::min(tMax, t1);
+			if (tMin > tMax)
+				return false;
+		}
+
+		return true;
+	}
+
+	// Will return whether the segment from + dir * ]0, 1[ crosses the triangle abc (Moeller-Trumbore)
+	bool SegmentHitsTriangle(const Vector3d& from, const Vector3d& dir, const Vector3d& a, const Vector3d& b, const Vector3d& c)
+	{
+		constexpr double epsilon = 1e-9;
+
+		const Vector3d ab = b - a;
+		const Vector3d ac = c - a;
+		const Vector3d p = dir.CrossProduct(ac);
+		const double det = ab.DotProduct(p);
+
+		// Segment is parallel to the triangle
+		if (std::abs(det) < epsilon)
+			return false;
+
+		const double invDet = 1.0 / det;
+		const Vector3d s = from - a;
+		const double u = s.DotProduct(p) * invDet;
+		if ((u < 0) || (u > 1))
+			return false;
+
+		const Vector3d q = s.CrossProduct(ab);
+		const double v = dir.DotProduct(q) * invDet;
+		if ((v < 0) || (u + v > 1))
+			return false;
+
+		// Don't count the segments end points touching a surface
+		const double t = ac.DotProduct(q) * invDet;
+		return (t > 1e-6) && (t < 1.0 - 1e-6);
+	}
+
+	// 64 bit FNV-1a
+	void HashBytes(std::uint64_t& hash, const void* data, std::size_t size)
+	{
+		const unsigned char* bytes = (const unsigned char*)data;
+		for (std::size_t i = 0; i < size; i++)
+		{
+			hash ^= bytes[i];
+			hash *= 1099511628211ull;
+		}
+
+		return;
+	}
+}
+
+void MeshPVS::Build(const std::vector<Vector3d>& vertices, const MeshBVH& bvh, TorGL::WorkerPool& workerPool, std::size_t cellsAlongLongestAxis, std::size_t raysPerNode)
+{
+	Clear();
+
+	const std::vector<MeshBVH::Node>& nodes = bvh.GetNodes();
+	const std::vector<TorGL::RenderVertexIndices>& tris = bvh.GetTris();
+	if (nodes.empty())
+		return;
+
+	numNodes = nodes.size();
+
+	// The grid spans the bounds of the whole mesh, with cubic cells
+	const Vector3d extent = nodes[0].boundsMax - nodes[0].boundsMin;
+	const double longestExtent = std::max(extent.x, std::max(extent.y, extent.z));
+
+	gridMin = nodes[0].boundsMin;
+	cellSize = (longestExtent > 0) ? longestExtent / std::max<std::size_t>(cellsAlongLongestAxis, 1) : 1.0;
+
+	for (std::size_t a = 0; a < 3; a++)
+		gridSize[a] = std::max<std::size_t>((std::size_t)std::ceil(extent[a] / cellSize - 1e-9), 1);
+
+	const std::size_t numCells = gridSize[0] * gridSize[1] * gridSize[2];
+	visibility.assign(numCells * numNodes, 0);
+
+	std::vector<std::size_t> leaves;
+	for (std::size_t i = 0; i < nodes.size(); i++)
+		if (nodes[i].skip == i + 1)
+			leaves.push_back(i);
+
+	// Sample the visibility of every leaf from every cell
+	std::vector<std::uint8_t> sampledVisibility(numCells * numNodes, 0);
+
+	workerPool.ParallelFor(0, numCells, 1,
+		[&](std::size_t begin, std::size_t end)
+		{
+			for (std::size_t cell = begin; cell < end; cell++)
+			{
+				// Seeded by the cell, so that building the same mesh twice results in the same sets
+				std::mt19937 rng((std::uint32_t)cell);
+				std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+				const Vector3d cellMin = gridMin + Vector3d(
+					(double)(cell % gridSize[0]),
+					(double)((cell / gridSize[0]) % gridSize[1]),
+					(double)(cell / (gridSize[0] * gridSize[1]))
+				) * cellSize;
+				const Vector3d cellMax = cellMin + Vector3d(cellSize, cellSize, cellSize);
+
+				// Grown by the margin, for the nearby leaves check
+				const double margin = cellSize * nearbyMarginInCells;
+				const Vector3d nearMin = cellMin - Vector3d(margin, margin, margin);
+				const Vector3d nearMax = cellMax + Vector3d(margin, margin, margin);
+
+				std::uint8_t* cellVisibility = sampledVisibility.data() + cell * numNodes;
+
+				for (const std::size_t leaf : leaves)
+				{
+					const MeshBVH::Node& node = nodes[leaf];
+
+					// Leaves reaching into, or coming close to the cell are always visible
+					if ((node.boundsMin.x <= nearMax.x) && (node.boundsMax.x >= nearMin.x) &&
+						(node.boundsMin.y <= nearMax.y) && (node.boundsMax.y >= nearMin.y) &&
+						(node.boundsMin.z <= nearMax.z) && (node.boundsMax.z >= nearMin.z))
+					{
+						cellVisibility[leaf] = 1;
+						continue;
+					}
+
+					// Otherwise, try to find an unblocked line of sight to any of its triangles
+					for (std::size_t r = 0; r < raysPerNode; r++)
+					{
+						const Vector3d from = cellMin + Vector3d(unit(rng), unit(rng), unit(rng)) * cellSize;
+
+						const std::size_t t = node.begin + (rng() % (node.end - node.begin));
+						const Vector3d& a = vertices[tris[t*3].v];
+						const Vector3d& b = vertices[tris[t*3 + 1].v];
+						const Vector3d& c = vertices[tris[t*3 + 2].v];
+
+						double u = unit(rng);
+						double v = unit(rng);
+						if (u + v > 1)
+						{
+							u = 1.0 - u;
+							v = 1.0 - v;
+						}
+
+						const Vector3d to = a + (b - a) * u + (c - a) * v;
+
+						if (!IsSegmentBlocked(from, to, vertices, bvh, node.begin, node.end))
+						{
+							cellVisibility[leaf] = 1;
+							break;
+						}
+					}
+				}
+			}
+		}
+	);
+
+	// Random rays miss leaves only visible through small openings, or at grazing angles.
+	// To make that less likely, every cell also sees all leaves any of its (up to 26) neighbouring cells have seen.
+	workerPool.ParallelFor(0, numCells, 1,
+		[&](std::size_t begin, std::size_t end)
+		{
+			for (std::size_t cell = begin; cell < end; cell++)
+			{
+				const std::size_t cellCoords[3] = {
+					cell % gridSize[0],
+					(cell / gridSize[0]) % gridSize[1],
+					cell / (gridSize[0] * gridSize[1])
+				};
+
+				// Neighbourhood, clamped to the grid
+				std::size_t neighboursMin[3];
+				std::size_t neighboursMax[3];
+				for (std::size_t a = 0; a < 3; a++)
+				{
+					neighboursMin[a] = (cellCoords[a] > 0) ? cellCoords[a] - 1 : 0;
+					neighboursMax[a] = std::min(cellCoords[a] + 1, gridSize[a] - 1);
+				}
+
+				std::uint8_t* cellVisibility = visibility.data() + cell * numNodes;
+
+				for (std::size_t z = neighboursMin[2]; z <= neighboursMax[2]; z++)
+					for (std::size_t y = neighboursMin[1]; y <= neighboursMax[1]; y++)
+						for (std::size_t x = neighboursMin[0]; x <= neighboursMax[0]; x++)
+						{
+							const std::uint8_t* neighbourVisibility = sampledVisibility.data() + (x + y * gridSize[0] + z * gridSize[0] * gridSize[1]) * numNodes;
+
+							for (const std::size_t leaf : leaves)
+								cellVisibility[leaf] |= neighbourVisibility[leaf];
+						}
+
+				// Inner nodes are visible, if any of their children is. Children always come after their parent.
+				for (std::size_t i = numNodes; i-- > 0;)
+					if (nodes[i].skip != i + 1)
+						cellVisibility[i] = cellVisibility[i + 1] | cellVisibility[nodes[i + 1].skip];
+			}
+		}
+	);
+
+	return;
+}
+
+bool MeshPVS::IsSegmentBlocked(const Vector3d& from, const Vector3d& to, const std::vector<Vector3d>& vertices, const MeshBVH& bvh, std::size_t ignoreBegin, std::size_t ignoreEnd)
+{
+	const std::vector<MeshBVH::Node>& nodes = bvh.GetNodes();
+	const std::vector<TorGL::RenderVertexIndices>& tris = bvh.GetTris();
+	const Vector3d dir = to - from;
+
+	std::size_t i = 0;
+	while (i < nodes.size())
+	{
+		const MeshBVH::Node& node = nodes[i];
+
+		// Skip ignored, and missed subtrees
+		if (((node.begin >= ignoreBegin) && (node.end <= ignoreEnd)) || (!SegmentHitsBox(from, dir, node.boundsMin, node.boundsMax)))
+		{
+			i = node.skip;
+			continue;
+		}
+
+		// Not a leaf. Check the children.
+		if (node.skip != i + 1)
+		{
+			i++;
+			continue;
+		}
+
+		for (std::size_t t = node.begin; t < node.end; t++)
+		{
+			if ((t >= ignoreBegin) && (t < ignoreEnd))
+				continue;
+
+			if (SegmentHitsTriangle(from, dir, vertices[tris[t*3].v], vertices[tris[t*3 + 1].v], vertices[tris[t*3 + 2].v]))
+				return true;
+		}
+
+		i = node.skip;
+	}
+
+	return false;
+}
+
+bool MeshPVS::SaveToFile(const std::string& filename, std::uint64_t meshHash) const
+{
+	std::ofstream ofs(filename, std::ios::binary | std::ios::trunc);
+	if (!ofs.good())
+		return false;
+
+	const std::uint64_t sizes[4] = { gridSize[0], gridSize[1], gridSize[2], numNodes };
+	const double grid[4] = { gridMin.x, gridMin.y, gridMin.z, cellSize };
+
+	ofs.write(fileMagic, sizeof(fileMagic));
+	ofs.write((const char*)&fileVersion, sizeof(fileVersion));
+	ofs.write((const char*)&meshHash, sizeof(meshHash));
+	ofs.write((const char*)sizes, sizeof(sizes));
+	ofs.write((const char*)grid, sizeof(grid));
+	ofs.write((const char*)visibility.data(), visibility.size());
+
+	return ofs.good();
+}
+
+bool MeshPVS::LoadFromFile(const std::string& filename, std::uint64_t meshHash)
+{
+	Clear();
+
+	std::ifstream ifs(filename, std::ios::binary);
+	if (!ifs.good())
+		return false;
+
+	char magic[sizeof(fileMagic)];
+	std::uint32_t version = 0;
+	std::uint64_t hash = 0;
+	std::uint64_t sizes[4] = { 0, 0, 0, 0 };
+	double grid[4] = { 0, 0, 0, 0 };
+
+	ifs.read(magic, sizeof(magic));
+	ifs.read((char*)&version, sizeof(version));
+	ifs.read((char*)&hash, sizeof(hash));
+	ifs.read((char*)sizes, sizeof(sizes));
+	ifs.read((char*)grid, sizeof(grid));
+
+	// Not a cache file of this version, or of another mesh
+	if ((!ifs.good()) || (std::memcmp(magic, fileMagic, sizeof(fileMagic)) != 0) || (version != fileVersion) || (hash != meshHash))
+		return false;
+
+	std::vector<std::uint8_t> data(sizes[0] * sizes[1] * sizes[2] * sizes[3]);
+	ifs.read((char*)data.data(), data.size());
+	if ((!ifs.good()) || (data.empty()))
+		return false;
+
+	gridSize[0] = sizes[0];
+	gridSize[1] = sizes[1];
+	gridSize[2] = sizes[2];
+	numNodes = sizes[3];
+	gridMin = Vector3d(grid[0], grid[1], grid[2]);
+	cellSize = grid[3];
+	visibility = std::move(data);
+
+	return true;
+}
+
+void MeshPVS::Clear()
+{
+	gridMin = Vector3d(0, 0, 0);
+	cellSize = 0;
+	gridSize[0] = gridSize[1] = gridSize[2] = 0;
+	numNodes = 0;
+	visibility.clear();
+
+	return;
+}
+
+bool MeshPVS::Empty() const
+{
+	return visibility.empty();
+}
+
+const std::uint8_t* MeshPVS::GetVisibleNodes(const Vector3d& point) const
+{
+	if (visibility.empty())
+		return nullptr;
+
+	std::size_t cell[3];
+	for (std::size_t a = 0; a < 3; a++)
+	{
+		const double c = std::floor((point[a] - gridMin[a]) / cellSize);
+		if ((c < 0) || (c >= (double)gridSize[a]))
+			return nullptr;
+
+		cell[a] = (std::size_t)c;
+	}
+
+	return visibility.data() + (cell[0] + cell[1] * gridSize[0] + cell[2] * gridSize[0] * gridSize[1]) * numNodes;
+}
+
+std::uint64_t MeshPVS::HashMesh(const std::vector<Vector3d>& vertices, const MeshBVH& bvh, std::size_t cellsAlongLongestAxis, std::size_t raysPerNode)
+{
+	std::uint64_t hash = 14695981039346656037ull;
+
+	// Same mesh, built differently, is a different pvs
+	const std::uint64_t parameters[2] = { cellsAlongLongestAxis, raysPerNode };
+	HashBytes(hash, parameters, sizeof(parameters));
+
+	for (const Vector3d& v : vertices)
+	{
+		const double xyz[3] = { v.x, v.y, v.z };
+		HashBytes(hash, xyz, sizeof(xyz));
+	}
+
+	for (const TorGL::RenderVertexIndices& idx : bvh.GetTris())
+	{
+		const std::uint64_t vi = idx.v;
+		HashBytes(hash, &vi, sizeof(vi));
+	}
+
+	for (const MeshBVH::Node& node : bvh.GetNodes())
+	{
+		const std::uint64_t range[3] = { node.begin, node.end, node.skip };
+		HashBytes(hash, range, sizeof(range));
+	}
+
+	return hash;
+}
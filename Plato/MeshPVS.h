@@ -0,0 +1,62 @@
+#pragma once
+#include "Vector.h"
+#include "MeshBVH.h"
+#include "../Tornado/WorkerPool.h"
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+namespace Plato
+{
+	/** Potentially visible set of a mesh with a bounding volume hierarchy.
+	* The bounding box of the mesh gets divided into a grid of cubic cells. For every cell, it stores which bvh nodes
+	* can be seen from anywhere within that cell, so that whole rooms hidden behind walls can be skipped while rendering.
+	* Visibility gets estimated by casting rays between random points in a cell and random points on the triangles of a leaf.
+	* Leaves close to a cell are always visible from it, and every cell also sees what its neighbouring cells see.
+	* This only makes misses less likely. The result is sampled, not conservative: Leaves only visible through narrow gaps
+	* can be missing, and then pop in or vanish while rendering. Meant for levels built from rooms and wide openings.
+	* The mesh itself is the only occluder. Like the bvh, everything is in object space.
+	*/
+	class MeshPVS
+	{
+	public:
+		//! Will compute the visible set of every cell. This is expensive, so consider caching the result with SaveToFile().
+		//! cellsAlongLongestAxis defines the grid resolution. raysPerNode is how many rays get cast per cell and leaf, before the leaf counts as hidden.
+		//! The cells get processed in parallel on workerPool. Do not call this from within a job of that same pool.
+		void Build(const std::vector<Vector3d>& vertices, const MeshBVH& bvh, TorGL::WorkerPool& workerPool, std::size_t cellsAlongLongestAxis = 16, std::size_t raysPerNode = 32);
+
+		//! Will write the visible sets to a cache file. meshHash identifies the mesh (see HashMesh()).
+		//! Returns false, if the file could not be written.
+		bool SaveToFile(const std::string& filename, std::uint64_t meshHash) const;
+
+		//! Will read the visible sets from a cache file.
+		//! Returns false, and stays empty, if there is no such file, or it was computed for a different mesh.
+		bool LoadFromFile(const std::string& filename, std::uint64_t meshHash);
+
+		//! Will remove all visible sets
+		void Clear();
+
+		//! Will return whether there are no visible sets
+		bool Empty() const;
+
+		//! Will return the visible set of the cell containing point. One entry per bvh node, non-zero if visible.
+		//! Returns nullptr, if point is outside of the grid. Everything could be visible from there.
+		const std::uint8_t* GetVisibleNodes(const Vector3d& point) const;
+
+		//! Will return a hash of the vertices, bvh and Build() parameters a pvs gets built from, to tell whether a cache file is still valid
+		static std::uint64_t HashMesh(const std::vector<Vector3d>& vertices, const MeshBVH& bvh, std::size_t cellsAlongLongestAxis = 16, std::size_t raysPerNode = 32);
+
+	private:
+		//! Will return whether any triangle outside of the triangle range [ignoreBegin, ignoreEnd) lays between from and to
+		static bool IsSegmentBlocked(const Vector3d& from, const Vector3d& to, const std::vector<Vector3d>& vertices, const MeshBVH& bvh, std::size_t ignoreBegin, std::size_t ignoreEnd);
+
+		Vector3d gridMin;
+		double cellSize = 0;
+		std::size_t gridSize[3] = { 0, 0, 0 };
+		std::size_t numNodes = 0;
+
+		//! numNodes entries per cell. x first, then y, then z.
+		std::vector<std::uint8_t> visibility;
+	};
+}
@@ -1,16 +1,24 @@
 #include "MeshRenderer.h"
 #include "Renderer.h"
+#include "../Eule/Constants.h"
+#include <atomic>
 
 using namespace Plato;
 using namespace Plato::Components;
 using namespace TorGL;
 
+namespace {
+	// Shared by all mesh renderers, so that no two ever report the same version
+	std::atomic<std::uint64_t> nextVersion = 1;
+}
+
 MeshRenderer::MeshRenderer(WorldObject* worldObject, Mesh* mesh, Material* material)
 	:
 	Component(worldObject)
 {
 	this->mesh = mesh;
 	this->material = material;
+	version = nextVersion++;
 
 	return;
 }
@@ -18,6 +26,7 @@ MeshRenderer::MeshRenderer(WorldObject* worldObject, Mesh* mesh, Material* mater
 void MeshRenderer::SetMesh(Mesh* mesh)
 {
 	this->mesh = mesh;
+	version = nextVersion++;
 	return;
 }
 
@@ -34,6 +43,7 @@ const Mesh* MeshRenderer::GetMesh() const
 void MeshRenderer::SetMaterial(Material* material)
 {
 	this->material = material;
+	version = nextVersion++;
 	return;
 }
 
@@ -47,6 +57,49 @@ const Material* MeshRenderer::GetMaterial() const
 	return material;
 }
 
+void MeshRenderer::SetLodPixelsPerTriangle(double pixelsPerTriangle)
+{
+	lodPixelsPerTriangle = pixelsPerTriangle;
+	return;
+}
+
+double MeshRenderer::GetLodPixelsPerTriangle() const
+{
+	return lodPixelsPerTriangle;
+}
+
+void MeshRenderer::SetCullDistance(double cullDistance)
+{
+	this->cullDistance = cullDistance;
+	return;
+}
+
+double MeshRenderer::GetCullDistance() const
+{
+	return cullDistance;
+}
+
+const Mesh* MeshRenderer::SelectLod(double screenRadius) const
+{
+	if ((mesh->lods.empty()) || (lodPixelsPerTriangle <= 0))
+		return mesh;
+
+	// Roughly how many triangles the screen area of the mesh can show
+	const double numTrianglesNeeded = (PI * screenRadius * screenRadius) / lodPixelsPerTriangle;
+
+	// Lods go from fine to coarse
+	for (std::size_t i = mesh->lods.size(); i-- > 0;)
+		if ((double)(mesh->lods[i].tris.size() / 3) >= numTrianglesNeeded)
+			return &mesh->lods[i];
+
+	return mesh;
+}
+
+std::uint64_t MeshRenderer::GetVersion() const
+{
+	return version;
+}
+
 void MeshRenderer::Render(Renderer* renderer)
 {
 	renderer->RegisterMeshRenderer(this);
@@ -2,6 +2,8 @@
 #include "Component.h"
 #include "Mesh.h"
 #include "Material.h"
+#include <limits>
+#include <cstdint>
 
 namespace Plato
 {
@@ -15,6 +17,7 @@ namespace Plato
 		class MeshRenderer : public Component
 		{
 		public:
+			//! Will set the mesh to render. Call this again after modifying the mesh, so that renderers resolve it anew.
 			void SetMesh(Mesh* mesh);
 			Mesh* GetMesh();
 			const Mesh* GetMesh() const;
@@ -23,6 +26,26 @@ namespace Plato
 			Material* GetMaterial();
 			const Material* GetMaterial() const;
 
+			//! Will set how many pixels a triangle should cover on average, when picking a level of detail of the mesh.
+			//! 0 always renders the full mesh.
+			void SetLodPixelsPerTriangle(double pixelsPerTriangle);
+			//! Will return how many pixels a triangle should cover on average, when picking a level of detail of the mesh
+			double GetLodPixelsPerTriangle() const;
+
+			//! Will set the distance to the camera, beyond which this mesh renderer gets culled. Infinity by default.
+			void SetCullDistance(double cullDistance);
+			//! Will return the distance to the camera, beyond which this mesh renderer gets culled
+			double GetCullDistance() const;
+
+			//! Will return the coarsest level of detail of the mesh, that still has enough triangles for screenRadius.
+			//! screenRadius is the radius of the meshes bounding sphere on screen, in pixels.
+			const Mesh* SelectLod(double screenRadius) const;
+
+			//! Will return a number that changes whenever the mesh or the material get set.
+			//! Never the same for two different mesh renderers. Renderers use this to tell when to resolve the mesh anew.
+			//! Modifications of the mesh itself are tracked by Mesh::GetVersion() instead.
+			std::uint64_t GetVersion() const;
+
 			void Render(Renderer* renderer);
 
             // This should be private, but g++ is not having it...
@@ -31,6 +54,9 @@ namespace Plato
 
 			Mesh* mesh;
 			Material* material;
+			double lodPixelsPerTriangle = 4.0;
+			double cullDistance = std::numeric_limits<double>::infinity();
+			std::uint64_t version;
 
 			friend class WorldObject;
 		};
@@ -0,0 +1,423 @@
+#include "MeshSimplifier.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+
+using namespace Plato;
+
+namespace {
+	constexpr std::size_t npos = (std::size_t)-1;
+
+	// Symmetric 4x4 matrix, summing up the squared distances of a point to a set of planes
+	struct Quadric
+	{
+		double a2 = 0, ab = 0, ac = 0, ad = 0;
+		double b2 = 0, bc = 0, bd = 0;
+		double c2 = 0, cd = 0;
+		double d2 = 0;
+
+		void AddPlane(const Vector3d& n, double d, double weight)
+		{
+			a2 += weight * n.x * n.x; ab += weight * n.x * n.y; ac += weight * n.x * n.z; ad += weight * n.x * d;
+			b2 += weight * n.y * n.y; bc += weight * n.y * n.z; bd += weight * n.y * d;
+			c2 += weight * n.z * n.z; cd += weight * n.z * d;
+			d2 += weight * d * d;
+
+			return;
+		}
+
+		void operator+=(const Quadric& o)
+		{
+			a2 += o.a2; ab += o.ab; ac += o.ac; ad += o.ad;
+			b2 += o.b2; bc += o.bc; bd += o.bd;
+			c2 += o.c2; cd += o.cd;
+			d2 += o.d2;
+
+			return;
+		}
+
+		double Error(const Vector3d& p) const
+		{
+			return
+				a2 * p.x * p.x + 2 * ab * p.x * p.y + 2 * ac * p.x * p.z + 2 * ad * p.x +
+				b2 * p.y * p.y + 2 * bc * p.y * p.z + 2 * bd * p.y +
+				c2 * p.z * p.z + 2 * cd * p.z +
+				d2;
+		}
+	};
+
+	// Moving vertex `from` onto vertex `to`. Versions tell whether the vertices changed since the cost was calculated.
+	struct Collapse
+	{
+		double cost;
+		std::uint32_t from;
+		std::uint32_t to;
+		std::uint32_t fromVersion;
+		std::uint32_t toVersion;
+
+		bool operator>(const Collapse& other) const
+		{
+			return cost > other.cost;
+		}
+	};
+
+	using Face = std::array<MeshVertexIndices, 3>;
+
+	std::uint64_t EdgeKey(std::size_t a, std::size_t b)
+	{
+		if (a > b)
+			std::swap(a, b);
+
+		return ((std::uint64_t)a << 32) | (std::uint64_t)b;
+	}
+
+	// Will remap an index into a compacted array, copying the value over on first use
+	template <typename T>
+	std::uint32_t Remap(std::uint32_t index, const std::vector<T>& source, std::vector<T>& target, std::vector<std::size_t>& remap)
+	{
+		// Out of range indices stay as they are
+		if (index >= source.size())
+			return index;
+
+		if (remap[index] == npos)
+		{
+			remap[index] = target.size();
+			target.push_back(source[index]);
+		}
+
+		return (std::uint32_t)remap[index];
+	}
+}
+
+std::vector<Mesh> MeshSimplifier::GenerateLods(const Mesh& mesh, std::size_t numLods, double reduction)
+{
+	std::vector<Mesh> lods;
+
+	const std::vector<Vector3d>& positions = mesh.v_vertices;
+	const std::size_t numVertices = positions.size();
+	const std::size_t numFaces = mesh.tris.size() / 3;
+
+	if ((numLods == 0) || (numFaces == 0))
+		return lods;
+
+	reduction = std::min(std::max(reduction, 0.01), 0.99);
+
+	// Gather faces, and their materials
+	std::vector<Face> faces(numFaces);
+	const std::vector<const Material*> faceMaterials = mesh.GetTriangleMaterials();
+	std::vector<bool> faceAlive(numFaces, true);
+	std::size_t numAliveFaces = numFaces;
+
+	for (std::size_t f = 0; f < numFaces; f++)
+	{
+		faces[f] = { mesh.tris[f*3], mesh.tris[f*3 + 1], mesh.tris[f*3 + 2] };
+	}
+
+	// Compute the quadrics, and find the vertices that must not move
+	std::vector<std::vector<std::uint32_t>> vertexFaces(numVertices);
+	std::vector<Quadric> quadrics(numVertices);
+	std::vector<bool> locked(numVertices, false);
+	std::vector<std::size_t> firstFace(numVertices, npos);
+	std::unordered_map<std::uint64_t, std::uint32_t> edgeFaceCounts;
+	edgeFaceCounts.reserve(numFaces * 2);
+
+	for (std::size_t f = 0; f < numFaces; f++)
+	{
+		const Face& face = faces[f];
+
+		// Plane of the face, weighted by its area
+		const Vector3d& p0 = positions[face[0].v];
+		Vector3d normal = (positions[face[1].v] - p0).CrossProduct(positions[face[2].v] - p0);
+		const double doubleArea = normal.Magnitude();
+
+		if (doubleArea > 0)
+		{
+			normal = normal / doubleArea;
+			for (std::size_t c = 0; c < 3; c++)
+				quadrics[face[c].v].AddPlane(normal, -normal.DotProduct(p0), doubleArea * 0.5);
+		}
+
+		for (std::size_t c = 0; c < 3; c++)
+		{
+			const std::size_t v = face[c].v;
+			vertexFaces[v].push_back((std::uint32_t)f);
+
+			// Vertices with different texture coordinates, normals or materials in different faces sit on a seam
+			if (firstFace[v] == npos)
+				firstFace[v] = f;
+			else
+			{
+				const Face& first = faces[firstFace[v]];
+				const MeshVertexIndices& firstCorner = (first[0].v == v) ? first[0] : (first[1].v == v) ? first[1] : first[2];
+				if ((firstCorner.uv != face[c].uv) || (firstCorner.vn != face[c].vn) || (faceMaterials[firstFace[v]] != faceMaterials[f]))
+					locked[v] = true;
+			}
+
+			edgeFaceCounts[EdgeKey(face[c].v, face[(c + 1) % 3].v)]++;
+		}
+	}
+
+	// Open borders, and non-manifold edges
+	for (const auto& [edge, count] : edgeFaceCounts)
+	{
+		if (count != 2)
+		{
+			locked[edge >> 32] = true;
+			locked[edge & 0xFFFFFFFF] = true;
+		}
+	}
+
+	std::vector<std::uint32_t> version(numVertices, 0);
+	std::vector<bool> vertexAlive(numVertices, true);
+	std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> heap;
+
+	const auto PushCollapse = [&](std::size_t from, std::size_t to)
+	{
+		if ((locked[from]) || (from == to))
+			return;
+
+		Quadric q = quadrics[from];
+		q += quadrics[to];
+		heap.push({ q.Error(positions[to]), (std::uint32_t)from, (std::uint32_t)to, version[from], version[to] });
+	};
+
+	for (const Face& face : faces)
+	{
+		for (std::size_t c = 0; c < 3; c++)
+		{
+			PushCollapse(face[c].v, face[(c + 1) % 3].v);
+			PushCollapse(face[(c + 1) % 3].v, face[c].v);
+		}
+	}
+
+	// Will collect the vertices sharing a face with v, sorted, without duplicates
+	std::vector<std::uint32_t> fromRing;
+	std::vector<std::uint32_t> toRing;
+	const auto GatherRing = [&](std::size_t v, std::vector<std::uint32_t>& ring)
+	{
+		ring.clear();
+		for (const std::uint32_t f : vertexFaces[v])
+		{
+			if (!faceAlive[f])
+				continue;
+
+			for (const MeshVertexIndices& corner : faces[f])
+				if (corner.v != v)
+					ring.push_back(corner.v);
+		}
+
+		std::sort(ring.begin(), ring.end());
+		ring.erase(std::unique(ring.begin(), ring.end()), ring.end());
+
+		return;
+	};
+
+	// Will return whether v has a face with both a and b
+	const auto HasFaceWith = [&](std::size_t v, std::size_t a, std::size_t b)
+	{
+		for (const std::uint32_t f : vertexFaces[v])
+		{
+			const Face& face = faces[f];
+			if ((faceAlive[f]) &&
+				((face[0].v == a) || (face[1].v == a) || (face[2].v == a)) &&
+				((face[0].v == b) || (face[1].v == b) || (face[2].v == b)))
+				return true;
+		}
+
+		return false;
+	};
+
+	// Will move vertex `from` onto vertex `to`, if that keeps the surface manifold, and doesn't flip any faces
+	const auto TryCollapse = [&](std::size_t from, std::size_t to)
+	{
+		// The faces around `from` take over the attributes `to` has in the faces they share.
+		// `from` is no seam, so these are all in the same texture chart.
+		// The third vertices of the shared faces are the wings of the edge.
+		const MeshVertexIndices* toCorner = nullptr;
+		std::size_t wings[2];
+		std::size_t numWings = 0;
+		for (const std::uint32_t f : vertexFaces[from])
+		{
+			if (!faceAlive[f])
+				continue;
+
+			for (const MeshVertexIndices& corner : faces[f])
+			{
+				if (corner.v != to)
+					continue;
+
+				if (toCorner == nullptr)
+					toCorner = &corner;
+				else if ((corner.uv != toCorner->uv) || (corner.vn != toCorner->vn))
+					return false;
+
+				// More than two faces on this edge
+				if (numWings == 2)
+					return false;
+
+				for (const MeshVertexIndices& wing : faces[f])
+					if ((wing.v != from) && (wing.v != to))
+						wings[numWings++] = wing.v;
+			}
+		}
+
+		// Not connected anymore
+		if (toCorner == nullptr)
+			return false;
+
+		const MeshVertexIndices toIndices = *toCorner;
+
+		// Link condition. Neighbours of both `from` and `to`, other than the wings, would end up with two faces on the same edge.
+		GatherRing(from, fromRing);
+		GatherRing(to, toRing);
+
+		std::size_t numSharedNeighbours = 0;
+		for (std::size_t i = 0, j = 0; (i < fromRing.size()) && (j < toRing.size());)
+		{
+			if (fromRing[i] < toRing[j])
+				i++;
+			else if (fromRing[i] > toRing[j])
+				j++;
+			else
+			{
+				numSharedNeighbours++;
+				i++;
+				j++;
+			}
+		}
+
+		if (numSharedNeighbours > numWings)
+			return false;
+
+		// If both `from` and `to` have a face on the edge between the wings, the collapse would fold these onto each other
+		if ((numWings == 2) && (HasFaceWith(from, wings[0], wings[1])) && (HasFaceWith(to, wings[0], wings[1])))
+			return false;
+
+		// The faces that stay must not flip over
+		for (const std::uint32_t f : vertexFaces[from])
+		{
+			const Face& face = faces[f];
+			if ((!faceAlive[f]) || (face[0].v == to) || (face[1].v == to) || (face[2].v == to))
+				continue;
+
+			const Vector3d& a = positions[face[0].v];
+			const Vector3d& b = positions[face[1].v];
+			const Vector3d& c = positions[face[2].v];
+			const Vector3d oldNormal = (b - a).CrossProduct(c - a);
+
+			const Vector3d& na = (face[0].v == from) ? positions[to] : a;
+			const Vector3d& nb = (face[1].v == from) ? positions[to] : b;
+			const Vector3d& nc = (face[2].v == from) ? positions[to] : c;
+			const Vector3d newNormal = (nb - na).CrossProduct(nc - na);
+
+			if (newNormal.DotProduct(oldNormal) <= 0)
+				return false;
+		}
+
+		// Collapse
+		for (const std::uint32_t f : vertexFaces[from])
+		{
+			Face& face = faces[f];
+			if (!faceAlive[f])
+				continue;
+
+			if ((face[0].v == to) || (face[1].v == to) || (face[2].v == to))
+			{
+				faceAlive[f] = false;
+				numAliveFaces--;
+				continue;
+			}
+
+			for (MeshVertexIndices& corner : face)
+				if (corner.v == from)
+					corner = toIndices;
+
+			vertexFaces[to].push_back(f);
+		}
+
+		vertexFaces[from].clear();
+		vertexFaces[to].erase(
+			std::remove_if(vertexFaces[to].begin(), vertexFaces[to].end(), [&faceAlive](std::uint32_t f) { return !faceAlive[f]; }),
+			vertexFaces[to].end()
+		);
+
+		quadrics[to] += quadrics[from];
+		vertexAlive[from] = false;
+		version[to]++;
+
+		// The costs of all edges around `to` changed
+		for (const std::uint32_t f : vertexFaces[to])
+		{
+			for (const MeshVertexIndices& corner : faces[f])
+			{
+				if (corner.v == to)
+					continue;
+
+				PushCollapse(corner.v, to);
+				PushCollapse(to, corner.v);
+			}
+		}
+
+		return true;
+	};
+
+	// Simplify step by step, and take a snapshot at every level
+	std::size_t previousNumFaces = numFaces;
+	std::size_t targetNumFaces = std::max<std::size_t>((std::size_t)(numFaces * reduction), 1);
+
+	while (lods.size() < numLods)
+	{
+		while ((numAliveFaces > targetNumFaces) && (!heap.empty()))
+		{
+			const Collapse collapse = heap.top();
+			heap.pop();
+
+			// Outdated
+			if ((!vertexAlive[collapse.from]) || (!vertexAlive[collapse.to]) || (version[collapse.from] != collapse.fromVersion) || (version[collapse.to] != collapse.toVersion))
+				continue;
+
+			TryCollapse(collapse.from, collapse.to);
+		}
+
+		// Not worth another level
+		if (numAliveFaces > previousNumFaces * (1.0 + reduction) * 0.5)
+			break;
+
+		Mesh& lod = lods.emplace_back();
+		std::vector<std::size_t> vRemap(numVertices, npos);
+		std::vector<std::size_t> uvRemap(mesh.uv_vertices.size(), npos);
+		std::vector<std::size_t> vnRemap(mesh.normals.size(), npos);
+		std::vector<const Material*> lodFaceMaterials;
+
+		for (std::size_t f = 0; f < numFaces; f++)
+		{
+			if (!faceAlive[f])
+				continue;
+
+			lodFaceMaterials.push_back(faceMaterials[f]);
+
+			for (const MeshVertexIndices& corner : faces[f])
+			{
+				lod.tris.push_back({
+					Remap(corner.v, positions, lod.v_vertices, vRemap),
+					Remap(corner.uv, mesh.uv_vertices, lod.uv_vertices, uvRemap),
+					Remap(corner.vn, mesh.normals, lod.normals, vnRemap)
+				});
+			}
+		}
+
+		lod.SetTriangleMaterials(lodFaceMaterials);
+		lod.RecalculateBounds();
+
+		previousNumFaces = numAliveFaces;
+		targetNumFaces = std::max<std::size_t>((std::size_t)(numAliveFaces * reduction), 1);
+
+		if (heap.empty())
+			break;
+	}
+
+	return lods;
+}
@@ -0,0 +1,21 @@
+#pragma once
+#include "Mesh.h"
+#include <vector>
+#include <cstddef>
+
+namespace Plato
+{
+	/** Generates simplified versions of a mesh, for levels of detail.
+	* Uses quadric error metrics to pick which edges to collapse. An edge collapse moves one vertex onto a neighbour,
+	* so every remaining vertex keeps its original position, texture coordinates and normal.
+	* Vertices on open borders, texture- or normal seams and material borders never get moved away, so these stay intact.
+	* Collapses that would pinch the surface into non-manifold edges or duplicate faces, or flip faces over, get skipped.
+	*/
+	class MeshSimplifier
+	{
+	public:
+		//! Will generate up to numLods simplified versions of mesh. Each one has about reduction times the triangles of the one before.
+		//! Stops early, if the mesh can't be simplified any further. The results have their bounds calculated.
+		static std::vector<Mesh> GenerateLods(const Mesh& mesh, std::size_t numLods, double reduction = 0.5);
+	};
+}
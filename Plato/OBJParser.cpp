@@ -4,6 +4,7 @@
 #include "ResourceManager.h"
 #include <filesystem>
 #include <iostream>
+#include <limits>
 #include <sstream>
 
 using namespace Plato;
@@ -25,6 +26,17 @@ Mesh OBJParser::ParseObj(
 		InterpretLine(line);
 
 	Mesh mesh = AssembleSubmeshes();
+
+    // Would be truncated to 32 bits, and point to entirely different vertices
+    if (indicesOutOfRange) {
+        std::cerr << "[WARNING] [OBJParser]: Obj file \""
+            << curObjFilePath
+            << "\" has vertex indices not fitting 32 bits! Rejecting the entire mesh!!!"
+            << std::endl;
+
+        mesh = Mesh();
+    }
+
 	Reset();
 	return mesh;
 }
@@ -258,16 +270,23 @@ void OBJParser::Interpret_f(const std::string& line)
 				if (ss.str().length() > 0)
 					try
 					{
+						// wavefront indices start at 1
+						const unsigned long wavefrontIndex = std::stoul(ss.str());
+						if ((wavefrontIndex == 0) || (wavefrontIndex - 1 > std::numeric_limits<std::uint32_t>::max()))
+							indicesOutOfRange = true;
+
+						const std::uint32_t index = (std::uint32_t)(wavefrontIndex - 1);
+
 						switch (slash_count)
 						{
 						case 0: // first position is v
-							newVertexIndices.v = std::stoul(ss.str()) - 1; // wavefront indices start at 1
+							newVertexIndices.v = index;
 							break;
 						case 1: // second position is vt/uv
-							newVertexIndices.uv = std::stoul(ss.str()) - 1;
+							newVertexIndices.uv = index;
 							break;
 						case 2: // third position is vn
-							newVertexIndices.vn = std::stoul(ss.str()) - 1;
+							newVertexIndices.vn = index;
 							break;
 						default:
 							throw std::runtime_error("Wavefront file syntax error! f-segment argument-count mismatch!");
@@ -285,13 +304,19 @@ void OBJParser::Interpret_f(const std::string& line)
 		}
 
 		curSubmesh.tris.push_back(newVertexIndices);
-        // If we are interpreting tris materials, and have a material, push it back
-        if (loadMtl && currentMaterial) {
-            curSubmesh.trisMaterialIndices[curSubmesh.tris.size()-1] = currentMaterial;
-        }
 		//std::cout << "f: " << Vector3i(newVertexIndices.v, newVertexIndices.uv, newVertexIndices.vn) << std::endl;
 	}
 
+    // If we are interpreting tris materials, and have a material, extend its range by this face (or start a new one)
+    if (loadMtl && currentMaterial) {
+        const std::size_t triangleIndex = curSubmesh.tris.size() / 3 - 1;
+
+        if ((!curSubmesh.submeshes.empty()) && (curSubmesh.submeshes.back().material == currentMaterial) && (curSubmesh.submeshes.back().end == triangleIndex))
+            curSubmesh.submeshes.back().end++;
+        else
+            curSubmesh.submeshes.push_back({ triangleIndex, triangleIndex + 1, currentMaterial });
+    }
+
 	return;
 }
 
@@ -408,13 +433,9 @@ Mesh OBJParser::AssembleSubmeshes()
 		toRet.uv_vertices.reserve(numTotal_uv);
 		toRet.normals.reserve(numTotal_vn);
 		toRet.tris.reserve(numTotal_tris);
-
-        if (loadMtl) {
-		    toRet.trisMaterialIndices.reserve(numTotal_tris);
-        }
 	}
 
-    std::size_t currentTrisOffset = 0;
+    std::size_t currentTrianglesOffset = 0;
 	for (const Mesh& submesh : submeshes)
 	{
 		if (submesh.v_vertices.size() == 0)
@@ -439,12 +460,12 @@ Mesh OBJParser::AssembleSubmeshes()
 			submesh.normals.end()
 		);
 
-        // Have to add tris material indices manually
+        // Have to offset the material ranges manually
         if (loadMtl) {
-            for (auto it : submesh.trisMaterialIndices) {
-                toRet.trisMaterialIndices[it.first + currentTrisOffset] = it.second;
+            for (const MeshSubmesh& range : submesh.submeshes) {
+                toRet.submeshes.push_back({ range.begin + currentTrianglesOffset, range.end + currentTrianglesOffset, range.material });
             }
-            currentTrisOffset += submesh.tris.size();
+            currentTrianglesOffset += submesh.tris.size() / 3;
         }
 
 
@@ -458,6 +479,11 @@ Mesh OBJParser::AssembleSubmeshes()
 				}
 			);
 	}
+
+    // Bring triangles sharing a material together, so that each material is a single range
+    if (loadMtl) {
+        toRet.SetTriangleMaterials(toRet.GetTriangleMaterials());
+    }
 	
 	return toRet;
 }
@@ -466,6 +492,7 @@ void OBJParser::Reset()
 {
 	submeshes.clear();
 	curSubmesh = Mesh();
+	indicesOutOfRange = false;
 
 	return;
 }
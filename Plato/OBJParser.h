@@ -63,6 +63,7 @@ namespace Plato
         bool loadMtl = false;
         std::string curObjFilePath;
         std::string mtlResourceNamePrefix;
+        bool indicesOutOfRange = false; // Set, if any f-line had an index that does not fit MeshVertexIndices
 	};
 
 }
@@ -2,6 +2,10 @@
 #include "Camera.h"
 #include "Mesh.h"
 #include "MeshRenderer.h"
+#include "../Tornado/ClippingEngine.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 using namespace Plato;
 using namespace Plato::Components;
@@ -21,8 +25,9 @@ Renderer::Renderer(
     double globalIllumination,
     Components::Camera const* camera
 ):
-	workerPool(numThreads),
-	tornado(renderResolution, numThreads, globalIllumination),
+	workerPool((numThreads == 0) ? &WorkerPool::GetShared() : new WorkerPool(numThreads)),
+	ownsWorkerPool(numThreads != 0),
+	tornado(renderResolution, workerPool, globalIllumination),
 	renderResolution { renderResolution },
 	camera { camera }
 {
@@ -35,6 +40,17 @@ Renderer::Renderer(
 	return;
 }
 
+Renderer::~Renderer()
+{
+	// The shared pool outlives all renderers
+	if (ownsWorkerPool)
+		delete workerPool;
+
+	workerPool = nullptr;
+
+	return;
+}
+
 
 void Renderer::BeginFrame()
 {
@@ -52,12 +68,12 @@ void Renderer::BeginFrame()
         }
     }
 
+	// Mesh renderers register anew every frame. What has been resolved for them is kept, until they stop registering.
+	frameIndex++;
 	meshRenderers.clear();
+	frameMeshes.clear();
 	lightSourceComponents.clear();
 
-	renderTriangles.clear();
-	renderTriangles.reserve(100); // Should be a few
-
 	tornadoLightSources.clear();
 	tornadoLightSources.reserve(10);
 
@@ -76,7 +92,16 @@ void Renderer::RegisterLightSource(const LightSource* lr)
 
 void Renderer::RegisterMeshRenderer(const MeshRenderer* mr)
 {
+	ResolvedMesh& resolvedMesh = resolvedMeshes[mr];
+
+	// Already registered this frame
+	if (resolvedMesh.registeredFrame == frameIndex)
+		return;
+
+	resolvedMesh.registeredFrame = frameIndex;
+
 	meshRenderers.emplace_back(mr);
+	frameMeshes.emplace_back(&resolvedMesh);
 	return;
 }
 
@@ -100,7 +125,10 @@ void Renderer::Render()
     #ifdef _BENCHMARK_CONTEXT
         perfTimer.Reset();
     #endif
-	ResolveRenderTriangles();
+    ProjectionProperties projectionProperties = camera->GetProjectionProperties();
+    projectionProperties.SetResolution(renderResolution);
+
+	ResolveRenderMeshes(projectionProperties);
 	ResolveLightSources();
     #ifdef _BENCHMARK_CONTEXT
         _benchmark_resolveCameraSpaceVerticesTime = perfTimer.GetElapsedTime().AsMilliseconds();
@@ -113,9 +141,10 @@ void Renderer::Render()
 	for (const RenderLightSource* lr : tornadoLightSources) {
 		tornado.RegisterRender(lr);
     }
-	// Register render triangles
-	for (const RenderTriangle3D& rd : renderTriangles) {
-		tornado.RegisterRender(&rd);
+	// Register render meshes, that survived frustum culling
+	for (const ResolvedMesh* resolvedMesh : frameMeshes) {
+		if (resolvedMesh->visible)
+			tornado.RegisterRender(&resolvedMesh->renderMesh);
     }
     #ifdef _BENCHMARK_CONTEXT
         _benchmark_registerTornadoObjects = perfTimer.GetElapsedTime().AsMilliseconds();
@@ -125,8 +154,6 @@ void Renderer::Render()
     #ifdef _BENCHMARK_CONTEXT
         perfTimer.Reset();
     #endif
-    ProjectionProperties projectionProperties = camera->GetProjectionProperties();
-    projectionProperties.SetResolution(renderResolution);
 	tornado.Render(projectionProperties, worldMatrix);
     #ifdef _BENCHMARK_CONTEXT
         _benchmark_tornadoRenderTime = perfTimer.GetElapsedTime().AsMilliseconds();
@@ -149,135 +176,424 @@ void Renderer::ResolveLightSources()
 		// Fetch tornado light source
 		RenderLightSource* rls = ls->GetRawTornadoRenderLightSource();
 		
-		// Transform to camera space
-		// These are references!
+		// Too far away from the camera
+		if (rls->GetPosition().Magnitude() > ls->GetCullDistance())
+			continue;
+
+		// Does the light reach any visible mesh at all?
+		const double range = rls->GetRange();
+		bool reachesAnyMesh = range == std::numeric_limits<double>::infinity();
+		for (std::size_t m = 0; (m < frameMeshes.size()) && (!reachesAnyMesh); m++)
+		{
+			const ResolvedMesh& resolvedMesh = *frameMeshes[m];
+			if ((resolvedMesh.visible) && ((resolvedMesh.sphereCenter - rls->GetPosition()).Magnitude() < resolvedMesh.sphereRadius + range))
+				reachesAnyMesh = true;
+		}
+
+		if (!reachesAnyMesh)
+			continue;
 
 		tornadoLightSources.emplace_back(rls);
 	}
 }
 
-void Renderer::ResolveRenderTriangles()
+void Renderer::ResolveRenderMeshes(const ProjectionProperties& projectionProperties)
 {
-	// Create resolving tasks
-	// Convert mesh renderers to individual world space triangles
-	for (const MeshRenderer* mr : meshRenderers)
+	// Drop everything kept for mesh renderers, that did not register this frame. They might not even exist anymore.
+	if (resolvedMeshes.size() > meshRenderers.size())
+		for (auto it = resolvedMeshes.begin(); it != resolvedMeshes.end();)
+		{
+			if (it->second.registeredFrame != frameIndex)
+				it = resolvedMeshes.erase(it);
+			else
+				++it;
+		}
+
+	// Split the mesh renderers vertices and normals into chunks
+	resolveChunks.clear();
+
+	// Same for all mesh renderers
+	const Matrix4x4 viewMatrix = camera->GetWorldSpaceToCameraSpaceMatrix();
+	const Matrix4x4 inverseCameraRotation = camera->transform->GetGlobalRotation().Inverse().ToRotationMatrix();
+
+	for (std::size_t m = 0; m < meshRenderers.size(); m++)
 	{
+		const MeshRenderer* mr = meshRenderers[m];
 		const Mesh* mesh = mr->GetMesh();
+		ResolvedMesh& resolvedMesh = *frameMeshes[m];
 
 		// Number of triangle vertex indices not a multiple of 3
 		if (mesh->tris.size() % 3 != 0)
 			throw std::runtime_error("Mesh tris.size() is broken!");
-	
-		for (std::size_t i = 0; i < mesh->tris.size();)
+
+		// The mesh or the material have been set. Nothing cached is of any use anymore.
+		if (resolvedMesh.meshRendererVersion != mr->GetVersion())
+		{
+			resolvedMesh.meshRendererVersion = mr->GetVersion();
+			resolvedMesh.positionsMesh = nullptr;
+			resolvedMesh.normalsMesh = nullptr;
+			resolvedMesh.visibleMesh = nullptr;
+		}
+
+		// Object space to world space. Only changes with the transform.
+		if (resolvedMesh.transformVersion != mr->transform->GetGlobalTransformVersion())
+		{
+			resolvedMesh.transformVersion = mr->transform->GetGlobalTransformVersion();
+			resolvedMesh.modelMatrix = mr->transform->GetGlobalTransformationMatrix();
+		}
+
+		// Compute the draw constants of this mesh renderer.
+		// Object space to world space, and then world space to camera space, combined into a single matrix.
+		resolvedMesh.modelView = viewMatrix.Multiply4x4(resolvedMesh.modelMatrix);
+
+		resolvedMesh.modelViewProjection = projectionProperties.GetProjectionMatrix().Multiply4x4(resolvedMesh.modelView);
+
+		// Find the camera space bounding sphere. Without bounds, all we know is the objects origin.
+		if (mesh->hasBounds)
+			TransformBoundingSphere(mesh, resolvedMesh.modelView, resolvedMesh.sphereCenter, resolvedMesh.sphereRadius);
+		else
+		{
+			resolvedMesh.sphereCenter = Vector3d(0, 0, 0) * resolvedMesh.modelView;
+			resolvedMesh.sphereRadius = std::numeric_limits<double>::infinity();
+		}
+
+		// Skip everything else, if the mesh renderer is too far away
+		const double distance = mesh->hasBounds ?
+			std::max(resolvedMesh.sphereCenter.Magnitude() - resolvedMesh.sphereRadius, 0.0) :
+			resolvedMesh.sphereCenter.Magnitude();
+
+		if (distance > mr->GetCullDistance())
+		{
+			resolvedMesh.visible = false;
+			continue;
+		}
+
+		// Skip everything else, if the mesh renderer is out of view
+		resolvedMesh.visible = IsInsideFrustum(mesh, resolvedMesh.modelView, resolvedMesh.modelViewProjection, projectionProperties.GetFarclip());
+		if (!resolvedMesh.visible)
+			continue;
+
+		// Pick the level of detail matching the meshes size on screen
+		if ((!mesh->lods.empty()) && (mesh->hasBounds))
+			mesh = mr->SelectLod(GetScreenRadius(mesh, resolvedMesh.modelView, projectionProperties));
+
+		resolvedMesh.mesh = mesh;
+
+		// Apply object- and camera rotation to the vertex normals
+		resolvedMesh.normalTransformation = resolvedMesh.modelMatrix.DropTranslationComponents() * inverseCameraRotation;
+
+		// Narrow it down to the triangles in view, and only resolve the vertices and normals these use
+		std::size_t numPositions = mesh->v_vertices.size();
+		std::size_t numNormals = mesh->normals.size();
+		bool visibleTrianglesChanged = false;
+
+		if (!mesh->bvh.Empty())
+		{
+			// Look up what can be seen from the cameras cell, if the camera is within the mesh
+			const std::uint8_t* visibleNodes = nullptr;
+			if (!mesh->pvs.Empty())
+				visibleNodes = mesh->pvs.GetVisibleNodes(Vector3d(0, 0, 0) * resolvedMesh.modelView.Inverse4x4());
+
+			visibleTrianglesChanged = CollectVisibleTriangles(mesh, resolvedMesh, visibleNodes);
+
+			resolvedMesh.visible = !resolvedMesh.visibleTris.empty();
+			if (!resolvedMesh.visible)
+				continue;
+
+			numPositions = resolvedMesh.visiblePositions.size();
+			numNormals = resolvedMesh.visibleNormals.size();
+		}
+
+		// Compute how many vertices to transform per chunk (scheduling overhead)
+		constexpr std::size_t numVerticesPerChunk = 256;
+
+		// Only transform the vertices again, if the camera or the object moved, or the mesh, or the triangles in view changed. Otherwise the buffers are still good.
+		// The sizes are checked as well, in case the mesh got modified in place without calling MarkModified().
+		if ((resolvedMesh.positionsMesh != mesh) || (resolvedMesh.positionsMeshVersion != mesh->GetVersion()) || (visibleTrianglesChanged) ||
+			(resolvedMesh.positionsModelView != resolvedMesh.modelView) || (resolvedMesh.positions.size() != numPositions))
+		{
+			resolvedMesh.positionsMesh = mesh;
+			resolvedMesh.positionsMeshVersion = mesh->GetVersion();
+			resolvedMesh.positionsModelView = resolvedMesh.modelView;
+			resolvedMesh.positions.resize(numPositions);
+
+			for (std::size_t i = 0; i < resolvedMesh.positions.size(); i += numVerticesPerChunk)
+				resolveChunks.push_back({ m, false, i, std::min(i + numVerticesPerChunk, resolvedMesh.positions.size()) });
+		}
+
+		if ((resolvedMesh.normalsMesh != mesh) || (resolvedMesh.normalsMeshVersion != mesh->GetVersion()) || (visibleTrianglesChanged) ||
+			(resolvedMesh.normalsTransformation != resolvedMesh.normalTransformation) || (resolvedMesh.normals.size() != numNormals))
+		{
+			resolvedMesh.normalsMesh = mesh;
+			resolvedMesh.normalsMeshVersion = mesh->GetVersion();
+			resolvedMesh.normalsTransformation = resolvedMesh.normalTransformation;
+			resolvedMesh.normals.resize(numNormals);
+
+			for (std::size_t i = 0; i < resolvedMesh.normals.size(); i += numVerticesPerChunk)
+				resolveChunks.push_back({ m, true, i, std::min(i + numVerticesPerChunk, resolvedMesh.normals.size()) });
+		}
+	}
+
+	// Transform all chunks
+	workerPool->ParallelFor(0, resolveChunks.size(), 1,
+		[this](std::size_t begin, std::size_t end)
+		{
+			for (std::size_t i = begin; i < end; i++)
+				Thread__ResolveMeshVertices(resolveChunks[i]);
+		}
+	);
+
+	// Point the tornado meshes to the resolved buffers
+	for (std::size_t m = 0; m < meshRenderers.size(); m++)
+	{
+		const MeshRenderer* mr = meshRenderers[m];
+		ResolvedMesh& resolvedMesh = *frameMeshes[m];
+		const Mesh* mesh = resolvedMesh.mesh;
+		RenderMesh3D& renderMesh = resolvedMesh.renderMesh;
+
+		if (!resolvedMesh.visible)
+			continue;
+
+		renderMesh.positions = resolvedMesh.positions.data();
+		renderMesh.numPositions = resolvedMesh.positions.size();
+		renderMesh.uvs = mesh->uv_vertices.data();
+		renderMesh.normals = resolvedMesh.normals.data();
+		renderMesh.material = mr->GetMaterial();
+
+		if (mesh->bvh.Empty())
 		{
-			WorkerTask* task = new WorkerTask(); // Will be freed by the workerPool
-
-			// Compute how many triangles to compute per task (mutex lock overhead)
-			const std::size_t optimalNumTrianglesForThisTask = 16;
-
-			// Either optimalNumTrianglesForThisTask, or what's left to not go out_of_range
-			const std::size_t numTrianglesForThisTask = 
-				((mesh->tris.size()/3 - i/3) >= optimalNumTrianglesForThisTask) ?
-					optimalNumTrianglesForThisTask
-					:
-					mesh->tris.size()/3 - i/3;
-
-			// Create task
-			task->task = std::bind(&Renderer::Thread__ResolveMeshRenderer_RenderTriangle, this,
-				mr,
-				&mesh->tris[i],
-				numTrianglesForThisTask
-			);
-
-			// Queue task
-			workerPool.QueueTask(task);
-			
-			// Advance loop
-			i += numTrianglesForThisTask * 3;
+			// The meshes material ranges can be handed to tornado as they are
+			renderMesh.indices = mesh->tris.data();
+			renderMesh.numTriangles = mesh->tris.size() / 3;
+			renderMesh.submeshes = mesh->submeshes.empty() ? nullptr : mesh->submeshes.data();
+			renderMesh.numSubmeshes = mesh->submeshes.size();
+		}
+		else
+		{
+			renderMesh.indices = resolvedMesh.visibleTris.data();
+			renderMesh.numTriangles = resolvedMesh.visibleTris.size() / 3;
+			renderMesh.submeshes = resolvedMesh.visibleSubmeshes.empty() ? nullptr : resolvedMesh.visibleSubmeshes.data();
+			renderMesh.numSubmeshes = resolvedMesh.visibleSubmeshes.size();
 		}
 	}
 
-	// Compute tasks
-	workerPool.Execute();
+	return;
+}
+
+bool Renderer::IsInsideFrustum(const Mesh* mesh, const Matrix4x4& modelView, const Matrix4x4& modelViewProjection, double farclip)
+{
+	// Can't tell without bounds
+	if (!mesh->hasBounds)
+		return true;
+
+	// Cheap test first: Is the bounding sphere completely behind the camera, or beyond the farclip?
+	Vector3d sphereCenter;
+	double sphereRadius;
+	TransformBoundingSphere(mesh, modelView, sphereCenter, sphereRadius);
+
+	// The camera looks along -z
+	if ((sphereCenter.z - sphereRadius >= 0) || (-sphereCenter.z - sphereRadius > farclip))
+		return false;
+
+	// Then check the bounding box against the frustum planes
+	return IsBoxInsideFrustum(mesh->boundsMin, mesh->boundsMax, modelViewProjection);
+}
+
+void Renderer::TransformBoundingSphere(const Mesh* mesh, const Matrix4x4& modelView, Vector3d& center, double& radius)
+{
+	// The sphere scales with the largest axis of the model view matrix
+	double maxSqrScale = 0;
+	for (std::size_t c = 0; c < 3; c++)
+		maxSqrScale = std::max(maxSqrScale, modelView[0][c] * modelView[0][c] + modelView[1][c] * modelView[1][c] + modelView[2][c] * modelView[2][c]);
+
+	center = mesh->boundingSphereCenter * modelView;
+	radius = mesh->boundingSphereRadius * sqrt(maxSqrScale);
 
 	return;
 }
 
-void Renderer::Thread__ResolveMeshRenderer_RenderTriangle(
-	const MeshRenderer* mr,
-	const MeshVertexIndices* idx,
-	std::size_t numTris
-)
+double Renderer::GetScreenRadius(const Mesh* mesh, const Matrix4x4& modelView, const ProjectionProperties& projectionProperties)
+{
+	Vector3d sphereCenter;
+	double sphereRadius;
+	TransformBoundingSphere(mesh, modelView, sphereCenter, sphereRadius);
+
+	// The camera is inside of the sphere
+	const double distance = -sphereCenter.z;
+	if (distance <= sphereRadius)
+		return std::numeric_limits<double>::infinity();
+
+	// Projected like a point at the spheres distance. [1][1] scales y to clipping space.
+	return (sphereRadius / distance) * projectionProperties.GetProjectionMatrix()[1][1] * projectionProperties.GetHalfResolution().y;
+}
+
+bool Renderer::IsBoxInsideFrustum(const Vector3d& boundsMin, const Vector3d& boundsMax, const Matrix4x4& modelViewProjection)
 {
-	const Mesh* mesh = mr->GetMesh();
+	Vector4d corners[8];
+	for (std::size_t i = 0; i < 8; i++)
+	{
+		corners[i] = Vector4d(
+			(i & 1) ? boundsMax.x : boundsMin.x,
+			(i & 2) ? boundsMax.y : boundsMin.y,
+			(i & 4) ? boundsMax.z : boundsMin.z,
+			1.0
+		) * modelViewProjection;
+	}
 
+	return !ClippingEngine::IsOutsideFrustum(corners, 8);
+}
 
-	// Cache the results of this iteration, to save on mutex operations
-	std::vector<RenderTriangle3D> resultCache;
-	resultCache.reserve(numTris);
+bool Renderer::CollectVisibleTriangles(const Mesh* mesh, ResolvedMesh& resolvedMesh, const std::uint8_t* visibleNodes)
+{
+	const std::vector<MeshBVH::Node>& nodes = mesh->bvh.GetNodes();
+	const std::vector<MeshVertexIndices>& tris = mesh->bvh.GetTris();
+	const std::vector<std::size_t>& triangleOrder = mesh->bvh.GetTriangleOrder();
+	const std::vector<MeshSubmesh>& submeshes = mesh->submeshes;
 
-    // Index of the first triangle this thread is processing
-    std::size_t baseTriangleIndex = idx - mesh->tris.data();
+	// Find the leaves in view. Depth first, without a stack. Culled nodes, and leaves, continue after their subtree.
+	resolvedMesh.collectedLeaves.clear();
 
-	for (std::size_t i = 0; i < numTris; i++)
+	std::size_t i = 0;
+	while (i < nodes.size())
 	{
-		RenderTriangle3D rd;
-        
-        // Does our mesh define a material for this specific face?
-        if (auto trisMatPair = mesh->trisMaterialIndices.find(baseTriangleIndex + i * 3); trisMatPair != mesh->trisMaterialIndices.end()) {
-            // Yes, a material is defined for this face...
-            // Set it.
-            rd.material = trisMatPair->second;
-        }
-        else {
-            // No, no material is defined for this face...
-            // Use the mesh renderer material instead...
-            rd.material = mr->GetMaterial();
-        }
+		const MeshBVH::Node& node = nodes[i];
 
-		// Transform vertices from object space to camera space
-		rd.a.pos_worldSpace = 
-			camera->WorldSpaceToCameraSpace(
-				mr->transform->ObjectSpaceToWorldSpace(mesh->v_vertices[idx[i*3 + 0].v])
-			);
+		// Hidden from the cameras cell, or out of view
+		if (((visibleNodes != nullptr) && (!visibleNodes[i])) || !IsBoxInsideFrustum(node.boundsMin, node.boundsMax, resolvedMesh.modelViewProjection))
+		{
+			i = node.skip;
+			continue;
+		}
 
-		rd.b.pos_worldSpace = 
-			camera->WorldSpaceToCameraSpace(
-				mr->transform->ObjectSpaceToWorldSpace(mesh->v_vertices[idx[i*3 + 1].v])
-			);
+		// Not a leaf. Check the children.
+		if (node.skip != i + 1)
+		{
+			i++;
+			continue;
+		}
 
-		rd.c.pos_worldSpace = 
-			camera->WorldSpaceToCameraSpace(
-				mr->transform->ObjectSpaceToWorldSpace(mesh->v_vertices[idx[i*3 + 2].v])
-			);
+		resolvedMesh.collectedLeaves.push_back(i);
+		i = node.skip;
+	}
 
+	// Usually, the camera moved only a bit, and still sees the same leaves. Nothing to collect then.
+	if ((resolvedMesh.visibleMesh == mesh) && (resolvedMesh.visibleMeshVersion == mesh->GetVersion()) && (resolvedMesh.collectedLeaves == resolvedMesh.visibleLeaves))
+		return false;
 
-		// Texture space can stay as is
-		rd.a.pos_textureSpace = mesh->uv_vertices[idx[i*3 + 0].uv];
-		rd.b.pos_textureSpace = mesh->uv_vertices[idx[i*3 + 1].uv];
-		rd.c.pos_textureSpace = mesh->uv_vertices[idx[i*3 + 2].uv];
+	resolvedMesh.visibleMesh = mesh;
+	resolvedMesh.visibleMeshVersion = mesh->GetVersion();
+	std::swap(resolvedMesh.visibleLeaves, resolvedMesh.collectedLeaves);
 
-		rd.a.normal = mesh->normals[idx[i*3 + 0].vn];
-		rd.b.normal = mesh->normals[idx[i*3 + 1].vn];
-		rd.c.normal = mesh->normals[idx[i*3 + 2].vn];
+	resolvedMesh.visibleTris.clear();
+	resolvedMesh.visibleSubmeshes.clear();
 
+	for (const std::size_t leaf : resolvedMesh.visibleLeaves)
+	{
+		const MeshBVH::Node& node = nodes[leaf];
 
-		// Apply object- and camera rotation to the vertex normals
-		const Matrix4x4 normalTransMat = mr->transform->GetGlobalTransformationMatrix().DropTranslationComponents() * camera->transform->GetGlobalRotation().Inverse().ToRotationMatrix();
-		rd.a.normal *= normalTransMat;
-		rd.b.normal *= normalTransMat;
-		rd.c.normal *= normalTransMat;
-		rd.a.normal.NormalizeSelf();
-		rd.b.normal.NormalizeSelf();
-		rd.c.normal.NormalizeSelf();
-
-		// Add to local result cache
-		resultCache.emplace_back(std::move(rd));
+		const std::size_t firstVisibleTriangle = resolvedMesh.visibleTris.size() / 3;
+		resolvedMesh.visibleTris.insert(resolvedMesh.visibleTris.end(), tris.begin() + node.begin * 3, tris.begin() + node.end * 3);
+
+		// Leaves keep the meshes triangle order, so its material ranges only have to be split where the leaf crosses them
+		if (!submeshes.empty())
+		{
+			// First range not ending before the leafs first triangle
+			std::size_t s = (std::size_t)(std::partition_point(submeshes.begin(), submeshes.end(),
+				[firstTriangle = triangleOrder[node.begin]](const MeshSubmesh& submesh)
+				{
+					return submesh.end <= firstTriangle;
+				}
+			) - submeshes.begin());
+
+			for (std::size_t t = node.begin; t < node.end; t++)
+			{
+				while ((s < submeshes.size()) && (triangleOrder[t] >= submeshes[s].end))
+					s++;
+
+				// Not covered by any range
+				const Material* material = ((s < submeshes.size()) && (triangleOrder[t] >= submeshes[s].begin)) ? submeshes[s].material : nullptr;
+				const std::size_t visibleTriangle = firstVisibleTriangle + (t - node.begin);
+
+				if ((!resolvedMesh.visibleSubmeshes.empty()) && (resolvedMesh.visibleSubmeshes.back().material == material))
+					resolvedMesh.visibleSubmeshes.back().end = visibleTriangle + 1;
+				else
+					resolvedMesh.visibleSubmeshes.push_back({ visibleTriangle, visibleTriangle + 1, material });
+			}
+		}
 	}
 
-	// After having calculated all iterations, add them all at once to the vector
-	std::lock_guard<std::mutex> lock(vecMutex);
-	renderTriangles.insert(renderTriangles.end(), resultCache.begin(), resultCache.end());
+	// Gather the vertices and normals of the visible triangles, and point the triangles to them, instead of the whole meshes.
+	// Out of range indices stay as they are.
+	constexpr std::uint32_t noSlot = std::numeric_limits<std::uint32_t>::max();
+	if (resolvedMesh.positionSlots.size() != mesh->v_vertices.size())
+		resolvedMesh.positionSlots.assign(mesh->v_vertices.size(), noSlot);
+	if (resolvedMesh.normalSlots.size() != mesh->normals.size())
+		resolvedMesh.normalSlots.assign(mesh->normals.size(), noSlot);
+
+	resolvedMesh.visiblePositions.clear();
+	resolvedMesh.visibleNormals.clear();
+
+	for (MeshVertexIndices& corner : resolvedMesh.visibleTris)
+	{
+		if (corner.v < resolvedMesh.positionSlots.size())
+		{
+			std::uint32_t& slot = resolvedMesh.positionSlots[corner.v];
+			if (slot == noSlot)
+			{
+				slot = (std::uint32_t)resolvedMesh.visiblePositions.size();
+				resolvedMesh.visiblePositions.push_back(corner.v);
+			}
+
+			corner.v = slot;
+		}
+
+		if (corner.vn < resolvedMesh.normalSlots.size())
+		{
+			std::uint32_t& slot = resolvedMesh.normalSlots[corner.vn];
+			if (slot == noSlot)
+			{
+				slot = (std::uint32_t)resolvedMesh.visibleNormals.size();
+				resolvedMesh.visibleNormals.push_back(corner.vn);
+			}
+
+			corner.vn = slot;
+		}
+	}
+
+	// Only reset what got used, so that this stays proportional to what is in view
+	for (const std::uint32_t v : resolvedMesh.visiblePositions)
+		resolvedMesh.positionSlots[v] = noSlot;
+	for (const std::uint32_t vn : resolvedMesh.visibleNormals)
+		resolvedMesh.normalSlots[vn] = noSlot;
+
+	return true;
+}
+
+void Renderer::Thread__ResolveMeshVertices(const ResolveChunk& chunk)
+{
+	ResolvedMesh& resolvedMesh = *frameMeshes[chunk.meshIndex];
+	const Mesh* mesh = resolvedMesh.mesh;
+
+	// Meshes with a bvh only resolve the vertices (and normals) of the triangles in view
+	const bool onlyVisible = !mesh->bvh.Empty();
+
+	if (chunk.isNormals)
+	{
+		for (std::size_t i = chunk.begin; i < chunk.end; i++)
+		{
+			Vector3d normal = mesh->normals[onlyVisible ? resolvedMesh.visibleNormals[i] : i];
+			normal *= resolvedMesh.normalTransformation;
+			normal.NormalizeSelf();
+
+			resolvedMesh.normals[i] = normal;
+		}
+	}
+	else
+	{
+		// Transform vertices from object space to camera space
+		for (std::size_t i = chunk.begin; i < chunk.end; i++)
+			resolvedMesh.positions[i] = mesh->v_vertices[onlyVisible ? resolvedMesh.visiblePositions[i] : i] * resolvedMesh.modelView;
+	}
 
 	return;
 }
@@ -315,3 +631,13 @@ void Renderer::SetCamera(Camera const* camera)
     this->camera = camera;
 }
 
+void Renderer::SetDrawMode(TorGL::DRAW_MODE mode)
+{
+    tornado.SetDrawMode(mode);
+}
+
+TorGL::DRAW_MODE Renderer::GetDrawMode() const
+{
+    return tornado.GetDrawMode();
+}
+
@@ -4,7 +4,8 @@
 #include "LightSource.h"
 #include "../Tornado/Tornado.h"
 #include "../Tornado/WorkerPool.h"
-#include <mutex>
+#include <unordered_map>
+#include <cstdint>
 
 namespace Plato
 {
@@ -15,14 +16,16 @@ namespace Plato
 	class Renderer
 	{
 	public:
-        // If numThreads is 0, std::thread::hardware_concurrency() will be used to determine
-        // the max number of threads of the system automatically
+        // If numThreads is 0, the process-wide TorGL::WorkerPool::GetShared() pool will be used,
+        // which has std::thread::hardware_concurrency() threads, and is shared with all other renderers.
+        // Otherwise, this renderer creates its own pool with numThreads threads.
         explicit Renderer(
             const Vector2i& renderResolution,
             std::size_t numThreads = 0,
             double globalIllumination = 0,
             Components::Camera const* camera = nullptr
         );
+        ~Renderer();
 
 		void BeginFrame();
 		void RegisterLightSource(const Components::LightSource* lr);
@@ -38,35 +41,129 @@ namespace Plato
 
 		const TorGL::PixelBuffer<3>* GetPixelBuffer() const;
 
-	private:
-		// Will translate plato light sources to tornado light sources
-		void ResolveLightSources();
+        // Will set how tornado draws triangles. Can be changed every frame.
+        void SetDrawMode(TorGL::DRAW_MODE mode);
 
-		// Will translate meshes (and their transforms) to camera-space render triangles
-		void ResolveRenderTriangles();
+        // Will return how tornado draws triangles
+        TorGL::DRAW_MODE GetDrawMode() const;
 
-		// Will resolve a single render triangle from a single mesh renderer
-		void Thread__ResolveMeshRenderer_RenderTriangle(
-			const Components::MeshRenderer* mr,
-			const MeshVertexIndices* idx,
-			std::size_t numTris
-		);
+	private:
+		// Will translate plato light sources to tornado light sources.
+		// Light sources beyond their cull distance, or whose range reaches no visible mesh, get skipped.
+		// Must be called after ResolveRenderMeshes().
+		void ResolveLightSources();
 
-		TorGL::WorkerPool workerPool;
+		// Will translate meshes (and their transforms) to camera-space, indexed render meshes.
+		// Every vertex and normal gets transformed once, no matter how many triangles share it.
+		// Mesh renderers outside of the view frustum, or beyond their cull distance, get skipped entirely.
+		// Vertices and normals only get transformed again, if the camera, the transform, or the mesh renderer changed.
+		void ResolveRenderMeshes(const TorGL::ProjectionProperties& projectionProperties);
+
+		// Will check the bounding volumes of a mesh, transformed by modelView, against the view frustum.
+		// Returns false only if nothing of the mesh can possibly be visible.
+		static bool IsInsideFrustum(const Mesh* mesh, const Eule::Matrix4x4& modelView, const Eule::Matrix4x4& modelViewProjection, double farclip);
+
+		// Will transform the bounding sphere of a mesh to camera space
+		static void TransformBoundingSphere(const Mesh* mesh, const Eule::Matrix4x4& modelView, Vector3d& center, double& radius);
+
+		// Will return the radius of a meshes bounding sphere on screen, in pixels. Infinity, if the camera is inside of it.
+		static double GetScreenRadius(const Mesh* mesh, const Eule::Matrix4x4& modelView, const TorGL::ProjectionProperties& projectionProperties);
+
+		// Will project the corners of an object space bounding box to clipping space, and check them against the view frustum.
+		// Returns false only if nothing inside the box can possibly be visible.
+		static bool IsBoxInsideFrustum(const Vector3d& boundsMin, const Vector3d& boundsMax, const Eule::Matrix4x4& modelViewProjection);
+
+		// The camera-space vertex buffers of a single mesh renderer, and the tornado mesh pointing into them
+		struct ResolvedMesh
+		{
+			const Mesh* mesh = nullptr; // The level of detail being rendered
+			std::vector<Vector3d> positions;
+			std::vector<Vector3d> normals;
+
+			// Draw constants. Computed once per frame, and then applied to all vertices.
+			Eule::Matrix4x4 modelView; // Object space to camera space
+			Eule::Matrix4x4 normalTransformation;
+			Eule::Matrix4x4 modelViewProjection; // Object space to clipping space
+			TorGL::RenderMesh3D renderMesh;
+
+			// False, if the mesh renderer got frustum- or distance culled this frame
+			bool visible = false;
+
+			// Camera space bounding sphere. Radius is infinity, if the mesh has no bounds.
+			Vector3d sphereCenter;
+			double sphereRadius = 0;
+
+			// Only used for meshes with a bvh. The triangles of all bvh nodes in view, and their material ranges.
+			// Their v and vn index into positions and normals, which only hold the vertices these triangles use.
+			std::vector<TorGL::RenderVertexIndices> visibleTris;
+			std::vector<TorGL::RenderSubmesh> visibleSubmeshes; // Empty, if the mesh has no material ranges
+			std::vector<std::uint32_t> visiblePositions; // The meshes vertex for every entry of positions
+			std::vector<std::uint32_t> visibleNormals; // The meshes normal for every entry of normals
+
+			// The bvh leaves the visible triangles have been collected from, of visibleMesh at visibleMeshVersion.
+			// If these stay the same, so do the visible triangles.
+			std::vector<std::size_t> visibleLeaves;
+			std::vector<std::size_t> collectedLeaves; // Scratch. The leaves in view this frame.
+			const Mesh* visibleMesh = nullptr;
+			std::uint64_t visibleMeshVersion = 0;
+
+			// Scratch. Per vertex (or normal) of the mesh, its index in visiblePositions (or visibleNormals), while collecting them.
+			std::vector<std::uint32_t> positionSlots;
+			std::vector<std::uint32_t> normalSlots;
+
+			// Cache. What the buffers above have been computed for, to not compute them again, if nothing changed.
+			std::uint64_t meshRendererVersion = 0;
+			std::uint64_t transformVersion = 0;
+			Eule::Matrix4x4 modelMatrix; // Object space to world space
+			const Mesh* positionsMesh = nullptr; // positions belong to this mesh, at positionsMeshVersion, transformed by positionsModelView
+			std::uint64_t positionsMeshVersion = 0;
+			Eule::Matrix4x4 positionsModelView;
+			const Mesh* normalsMesh = nullptr; // normals belong to this mesh, at normalsMeshVersion, transformed by normalsTransformation
+			std::uint64_t normalsMeshVersion = 0;
+			Eule::Matrix4x4 normalsTransformation;
+
+			// The last frame the mesh renderer got registered in
+			std::size_t registeredFrame = 0;
+		};
+
+		// A range of vertices (or normals) of a single mesh renderer, resolved in one go
+		struct ResolveChunk
+		{
+			std::size_t meshIndex;
+			bool isNormals;
+			std::size_t begin;
+			std::size_t end;
+		};
+
+		// Will transform the vertices (or normals) of a single chunk
+		void Thread__ResolveMeshVertices(const ResolveChunk& chunk);
+
+		// Will traverse the bvh of a mesh, and collect the triangles of all nodes in view, and the vertices and normals they use.
+		// visibleNodes is the pvs of the cameras cell, or nullptr to consider all nodes.
+		// Returns false, if the same leaves as last time are in view. Then everything collected before gets kept.
+		static bool CollectVisibleTriangles(const Mesh* mesh, ResolvedMesh& resolvedMesh, const std::uint8_t* visibleNodes);
+
+		// One per mesh renderer. Kept between frames, to not resolve everything anew every frame.
+		// Entries of mesh renderers, that did not get registered in a frame, get dropped.
+		std::unordered_map<const Components::MeshRenderer*, ResolvedMesh> resolvedMeshes;
+		std::vector<ResolvedMesh*> frameMeshes; // Same order as meshRenderers
+		std::vector<ResolveChunk> resolveChunks;
+		std::size_t frameIndex = 1; // Never 0, so that new entries don't count as registered
+
+		// Used by both, the resolving here, and all of tornados stages. Declared before tornado, as it gets constructed with it.
+		TorGL::WorkerPool* workerPool;
+		bool ownsWorkerPool;
 
 		TorGL::Tornado tornado;
 		std::vector<const Components::MeshRenderer*> meshRenderers;
 		std::vector<const Components::LightSource*> lightSourceComponents;
 
-		std::vector<TorGL::RenderTriangle3D> renderTriangles;
 		std::vector<TorGL::RenderLightSource*> tornadoLightSources;
 
 		Eule::Matrix4x4 worldMatrix;
 		const Vector2i& renderResolution;
 		Components::Camera const* camera;
 
-		std::mutex vecMutex;
-
         // Benchmarking stuff
         #ifdef _BENCHMARK_CONTEXT
         double _benchmark_beginFrameTime;
@@ -1,5 +1,6 @@
 #include "ResourceManager.h"
 #include "Color.h"
+#include <iostream>
 
 using namespace BMPlib;
 using namespace Plato;
@@ -79,7 +80,7 @@ Texture* ResourceManager::LoadTextureFromBmp(const std::string& name, const std:
 	return text;
 }
 
-Mesh* ResourceManager::LoadMeshFromObj(const std::string& name, const std::string& filename, bool loadMtlFile)
+Mesh* ResourceManager::LoadMeshFromObj(const std::string& name, const std::string& filename, bool loadMtlFile, bool buildBVH, bool buildPVS, std::size_t numLods, TorGL::WorkerPool& workerPool)
 {
 	// Name already taken!
 	if (meshes.find(name) != meshes.end())
@@ -87,6 +88,38 @@ Mesh* ResourceManager::LoadMeshFromObj(const std::string& name, const std::strin
 
 	Mesh* mesh = new Mesh(OBJParser().ParseObj(filename, loadMtlFile, name));
 
+	// A single vertex buffer is much more cache friendly, but every vertex then also has a normal to resolve each frame.
+	// Not worth it for meshes sharing few normals among many vertices, like flat shaded levels.
+	constexpr double maxResolveGrowth = 1.25;
+	if (mesh->CountUniqueVertices() * 2 <= (mesh->v_vertices.size() + mesh->normals.size()) * maxResolveGrowth)
+		mesh->UnifyVertices();
+
+	mesh->RecalculateBounds();
+
+	if (numLods > 0)
+		mesh->GenerateLods(numLods);
+
+	if (buildBVH || buildPVS)
+		mesh->BuildBVH();
+
+	// Computing the pvs takes a while. Cache it next to the obj file.
+	if (buildPVS)
+	{
+		constexpr std::size_t pvsCellsAlongLongestAxis = 16;
+		constexpr std::size_t pvsRaysPerNode = 32;
+
+		const std::string pvsFilename = filename + ".pvs";
+		const std::uint64_t meshHash = MeshPVS::HashMesh(mesh->v_vertices, mesh->bvh, pvsCellsAlongLongestAxis, pvsRaysPerNode);
+
+		if (!mesh->pvs.LoadFromFile(pvsFilename, meshHash))
+		{
+			mesh->BuildPVS(workerPool, pvsCellsAlongLongestAxis, pvsRaysPerNode);
+
+			if (!mesh->pvs.SaveToFile(pvsFilename, meshHash))
+				std::cerr << "[WARNING] [ResourceManager]: Could not write pvs cache file \"" << pvsFilename << "\"" << std::endl;
+		}
+	}
+
 	meshes.insert(
 		std::pair<std::string, Mesh*>(name, mesh)
 	);
@@ -141,12 +174,12 @@ Texture* ResourceManager::FindTextureOrLoadFromBmp(const std::string &name, cons
     return texture;
 }
 
-Mesh* ResourceManager::FindMeshOrLoadFromObj(const std::string &name, const std::string &filename, bool loadMtlFile)
+Mesh* ResourceManager::FindMeshOrLoadFromObj(const std::string &name, const std::string &filename, bool loadMtlFile, bool buildBVH, bool buildPVS, std::size_t numLods, TorGL::WorkerPool& workerPool)
 {
     Mesh* mesh = FindMesh(name);
 
     if (!mesh) {
-        mesh = LoadMeshFromObj(name, filename, loadMtlFile);
+        mesh = LoadMeshFromObj(name, filename, loadMtlFile, buildBVH, buildPVS, numLods, workerPool);
     }
 
     return mesh;
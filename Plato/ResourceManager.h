@@ -5,6 +5,7 @@
 #include "Mesh.h"
 #include "bmplib.h"
 #include "OBJParser.h"
+#include "../Tornado/WorkerPool.h"
 
 namespace Plato
 {
@@ -35,7 +36,17 @@ namespace Plato
         //! obj file, attempt to load it (emit a warning if it doesnt exist),
         //! which creates textures and materials from this mtl, and will assign these materials
         //! to individual faces of the loaded mesh, as defined in the obj file.
-		static Mesh* LoadMeshFromObj(const std::string& name, const std::string& filename, bool loadMtlFile = false);
+        //! If buildBVH is true, a bounding volume hierarchy gets built over its triangles,
+        //! so that the renderer only draws the parts in view. Use it for big meshes, like whole levels.
+        //! If buildPVS is true, a bvh gets built, and a potentially visible set for its nodes on top,
+        //! so that the renderer can also skip parts hidden behind walls. Use it for static level geometry.
+        //! The pvs is sampled (see MeshPVS), so parts only visible through narrow gaps might not get drawn.
+        //! It gets computed on workerPool. Pass the pool of the renderer, if it has its own, and never call this from within one of its jobs.
+        //! The pvs gets cached in a file next to the obj file (filename + ".pvs"), and only gets recomputed if the mesh changed.
+        //! numLods simplified levels of detail get generated, each with about half the triangles of the one before (see MeshSimplifier).
+        //! Mesh renderers then pick one depending on the meshes size on screen. Use it for detailed meshes, that are often seen from afar.
+        //! The vertex buffers get unified (see Mesh::UnifyVertices()), if that does not mean resolving a lot more vertices and normals.
+		static Mesh* LoadMeshFromObj(const std::string& name, const std::string& filename, bool loadMtlFile = false, bool buildBVH = false, bool buildPVS = false, std::size_t numLods = 0, TorGL::WorkerPool& workerPool = TorGL::WorkerPool::GetShared());
 
 
 
@@ -61,7 +72,9 @@ namespace Plato
         //! obj file, attempt to load it (emit a warning if it doesnt exist),
         //! which creates textures and materials from this mtl, and will assign these materials
         //! to individual faces of the loaded mesh, as defined in the obj file.
-        static Mesh* FindMeshOrLoadFromObj(const std::string& name, const std::string& filename, bool loadMtlFile = false);
+        //! If buildBVH is true, a bounding volume hierarchy gets built over its triangles, if it has to be loaded.
+        //! Same goes for buildPVS, and a potentially visible set, and numLods levels of detail (see LoadMeshFromObj()).
+        static Mesh* FindMeshOrLoadFromObj(const std::string& name, const std::string& filename, bool loadMtlFile = false, bool buildBVH = false, bool buildPVS = false, std::size_t numLods = 0, TorGL::WorkerPool& workerPool = TorGL::WorkerPool::GetShared());
 
 		static void Free();
 
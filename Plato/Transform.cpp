@@ -1,13 +1,20 @@
 #include "Transform.h"
+#include <atomic>
 
 using namespace Plato;
 
+namespace {
+	// Shared by all transforms, so that no two ever report the same version
+	std::atomic<std::uint64_t> nextGlobalTransformVersion = 1;
+}
+
 Transform::Transform()
 	:
 	worldObject { privateHandle__WorldObject }
 {
 	parent = nullptr;
 	privateHandle__WorldObject = nullptr; // Will get set immediately after instantiation by the WorldObjectManager
+	globalTransformVersion = nextGlobalTransformVersion++;
 
 	return;
 }
@@ -305,6 +312,7 @@ void Transform::InvalidateGlobalTransform()
 {
 	// Invalidate own
 	cache__IsGlobalTransformation_UpToDate = false;
+	globalTransformVersion = nextGlobalTransformVersion++;
 
 	// Invalidate of children
 	for (Transform* tr : children)
@@ -313,6 +321,11 @@ void Transform::InvalidateGlobalTransform()
 	return;
 }
 
+std::uint64_t Transform::GetGlobalTransformVersion() const
+{
+	return globalTransformVersion;
+}
+
 void Transform::RecalculateGlobalTransformCache() const
 {
 	// Re-Calculate global transformation matrix
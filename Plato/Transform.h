@@ -4,6 +4,7 @@
 #include "Vector.h"
 #include <unordered_set>
 #include <mutex>
+#include <cstdint>
 
 namespace Plato
 {
@@ -104,6 +105,10 @@ namespace Plato
 		// Will recalculate the global transform values. You should only call this when cache__isGlobal... is false
 		void RecalculateGlobalTransformCache() const;
 
+		//! Will return a number that changes whenever the global transformation changes, including through a parent.
+		//! Never the same for two different transforms. Meant for caching things derived from the global transformation.
+		std::uint64_t GetGlobalTransformVersion() const;
+
 	private:
 		Matrix4x4 scaleMatrix;
 		Matrix4x4 translationMatrix;
@@ -121,6 +126,7 @@ namespace Plato
 		mutable bool		cache__IsGlobalTransformation_UpToDate = false;
 		mutable Vector3d	cache__GlobalPosition;
 		mutable Quaternion	cache__GlobalRotation;
+		std::uint64_t		globalTransformVersion;
 
 		// Stores pointers to all child transforms
 		std::unordered_set<Transform*> children;
@@ -25,7 +25,7 @@ Dust2Scene::Dust2Scene()
 
     // Load Dust2 assets
     const std::string assetsDir = "../../Scenes/Fun/Dust2/assets";
-    Mesh* dust2Mesh = ResourceManager::LoadMeshFromObj("dust2", assetsDir+"/dust2.obj", true);
+    Mesh* dust2Mesh = ResourceManager::LoadMeshFromObj("dust2", assetsDir+"/dust2.obj", true, true);
 
   // Create the dust2 map world object
   WorldObject *dust2Wo = WorldObjectManager::NewWorldObject("dust2 map");
@@ -24,7 +24,7 @@ MC_HouseScene::MC_HouseScene() : Scene(__FUNCTION__) // Set the test fixtures na
     Texture* texture = ResourceManager::FindTextureOrLoadFromBmp("mc_world", assetsDir+"/mc_world_tran.bmp");
 
 	// Load mesh files
-    Mesh* mesh = ResourceManager::FindMeshOrLoadFromObj("mc_world", assetsDir+"/mc_world.obj");
+    Mesh* mesh = ResourceManager::FindMeshOrLoadFromObj("mc_world", assetsDir+"/mc_world.obj", false, true);
 
 	// Create materials
     Material* mat = ResourceManager::NewMaterial("mc_world");
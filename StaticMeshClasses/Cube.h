@@ -60,6 +60,8 @@ public:
 			{3, 11, 5}, { 1, 13, 5}, {5,  7, 5}
 		};
 
+		RecalculateBounds();
+
 		return;
 	}
 };
@@ -34,20 +34,14 @@ void BackfaceCullingEngine::RegisterInterRenderTriangle(const InterRenderTriangl
 
 void BackfaceCullingEngine::Cull()
 {
-	// Create and queue worker tasks
-	for (auto& tri : registeredTriangles)
-	{
-		WorkerTask* newTask = new WorkerTask; // Will be freed by the workerPool
-
-		newTask->task = std::bind(&BackfaceCullingEngine::Thread__CullTriangle, this,
-			&tri
-		);
-
-		workerPool->QueueTask(newTask);
-	}
-
-	// Execute worker tasks
-	workerPool->Execute();
+	// Let the pool chunk the triangles. No per-triangle task allocation.
+	workerPool->ParallelFor(0, registeredTriangles.size(), 0,
+		[this](std::size_t begin, std::size_t end)
+		{
+			for (std::size_t i = begin; i < end; i++)
+				Thread__CullTriangle(&registeredTriangles[i]);
+		}
+	);
 
 	return;
 }
@@ -74,6 +68,19 @@ void BackfaceCullingEngine::Thread__CullTriangle(std::pair<const InterRenderTria
 	return;
 }
 
+bool BackfaceCullingEngine::IsFrontFacing(const Vector4d& a, const Vector4d& b, const Vector4d& c)
+{
+	// Determinant of the homogeneous (x, y, w) vertex matrix. For w = 1 this is exactly the z component of the
+	// ndc surface normal, Cull() looks at. In general, it's that, times the product of the ws.
+	// Clipping only ever creates convex combinations of these vertices, and keeps their order, so the sign holds for all clipped triangles too.
+	const double det =
+		a.x * (b.y * c.w - b.w * c.y) -
+		a.y * (b.x * c.w - b.w * c.x) +
+		a.w * (b.x * c.y - b.y * c.x);
+
+	return det > 0;
+}
+
 std::vector<const InterRenderTriangle*>& BackfaceCullingEngine::Finish()
 {
 	culledTriangles.reserve(registeredTriangles.size());
@@ -26,6 +26,11 @@ namespace TorGL
 		//! They point to the elements in the original vector.
 		std::vector<const InterRenderTriangle*>& Finish();
 
+		//! Will return whether a triangle faces the camera, given its vertices in homogeneous clipping space.
+		//! This works before clipping and the perspective divide, even for triangles crossing the near plane,
+		//! and agrees with Cull() on all the triangles clipping produces from it. Zero-area triangles do not face the camera.
+		static bool IsFrontFacing(const Vector4d& a, const Vector4d& b, const Vector4d& c);
+
 	private:
 		WorkerPool* workerPool;
 		std::vector<const InterRenderTriangle*> culledTriangles;
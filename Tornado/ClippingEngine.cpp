@@ -11,31 +11,47 @@ using namespace TorGL;
 
 #define PlaneByOutcode(code, plane) (((uint8_t)code & (1 << plane)) ? 1 : 0)
 
-std::vector<InterRenderTriangle> ClippingEngine::Clip(const InterRenderTriangle& tri)
+std::vector<InterRenderTriangle> ClippingEngine::Clip(const InterRenderTriangle& tri, double guardBand)
 {
-	std::vector<InterRenderTriangle> clippingResult; // <-- Stores our triangles
+	ClippingResult clippingResult;
+	Clip(tri, clippingResult, guardBand);
 
-	// Calculate outcodes for original triangle vertices
-	uint8_t outcode_a = Outcode(tri.a.pos_cs);
-	uint8_t outcode_b = Outcode(tri.b.pos_cs);
-	uint8_t outcode_c = Outcode(tri.c.pos_cs);
+	return std::vector<InterRenderTriangle>(clippingResult.begin(), clippingResult.end());
+}
 
-	// Fast accept. Triangle is completely visible
-	if ((outcode_a | outcode_b | outcode_c) == 0)
-	{
-		clippingResult.push_back(tri);
-		return clippingResult;
-	}
+void ClippingEngine::Clip(const InterRenderTriangle& tri, ClippingResult& clippingResult, double guardBand)
+{
+	clippingResult.Clear();
+
+	// Calculate outcodes for original triangle vertices, against the actual screen edges
+	uint8_t outcode_a = Outcode(tri.a.pos_cs, 1.0);
+	uint8_t outcode_b = Outcode(tri.b.pos_cs, 1.0);
+	uint8_t outcode_c = Outcode(tri.c.pos_cs, 1.0);
 
 	// Fast reject. Triangle is completely out of sight.
 	// This being false does NOT mean the triangle is automatically visible!
 	// This being true does just mean that all vertices are on wrong side of the same edge
+	// Tested against the screen edges, not the guard band, as there's nothing to draw outside of the screen anyway.
 	if (outcode_a & outcode_b & outcode_c)
-		return clippingResult; // <- empty
+		return; // <- empty
+
+	// Now against the guard band
+	if (guardBand != 1.0)
+	{
+		outcode_a = Outcode(tri.a.pos_cs, guardBand);
+		outcode_b = Outcode(tri.b.pos_cs, guardBand);
+		outcode_c = Outcode(tri.c.pos_cs, guardBand);
+	}
+
+	// Fast accept. Triangle is completely visible, or only leaves the screen within the guard band
+	if ((outcode_a | outcode_b | outcode_c) == 0)
+	{
+		clippingResult.PushBack(tri);
+		return;
+	}
 
 	// If the triangle made it here, we actually have to clip it... *sigh*
-	clippingResult.reserve(64); // Mathematically impossible to get more triangles out of one when clipping in three dimensions (homogenous coords are technically just distorted 3d coordinates)
-	clippingResult.push_back(tri);
+	clippingResult.PushBack(tri);
 
 	constexpr long long interpolationMask = IRV_LERP_POS_WS | IRV_LERP_POS_CS | IRV_LERP_POS_UV | IRV_LERP_NORMAL;
 	clippingResult[0].a.SetInterpolationMask(interpolationMask);
@@ -51,37 +67,37 @@ std::vector<InterRenderTriangle> ClippingEngine::Clip(const InterRenderTriangle&
 	// 6 -> far
 	for (uint8_t e = 0; e < 6; e++)
 	{
-		for (long t = (long)clippingResult.size() - 1; t >= 0; t--)
+		for (long t = (long)clippingResult.Size() - 1; t >= 0; t--)
 		{
 			InterRenderTriangle splitTri;
 			bool hasSplitTri;
 			bool hasDroppedTriangle;
-			ClipEdge(e, clippingResult[t], splitTri, hasDroppedTriangle, hasSplitTri);
+			ClipEdge(e, guardBand, clippingResult[t], splitTri, hasDroppedTriangle, hasSplitTri);
 
 			// Dump it
 			if (hasDroppedTriangle)
-				clippingResult.erase(clippingResult.begin() + t);
+				clippingResult.Erase(t);
 
 			// Oh my, we got an additional triangle for that face! Let's carry over the metadata!
 			if (hasSplitTri)
 			{
 				splitTri.material = clippingResult[t].material;
-				clippingResult.push_back(splitTri);
+				clippingResult.PushBack(splitTri);
 			}
 		}
 	}
 
-	return clippingResult;
+	return;
 }
 
-void ClippingEngine::ClipEdge(uint8_t edge, InterRenderTriangle& tri, InterRenderTriangle& split_tri, bool& hasDroppedTri, bool& hasSplitTri)
+void ClippingEngine::ClipEdge(uint8_t edge, double guardBand, InterRenderTriangle& tri, InterRenderTriangle& split_tri, bool& hasDroppedTri, bool& hasSplitTri)
 {
 	hasSplitTri = false;
 	hasDroppedTri = false;
 
-	uint8_t outcode_a = Outcode(tri.a.pos_cs);
-	uint8_t outcode_b = Outcode(tri.b.pos_cs);
-	uint8_t outcode_c = Outcode(tri.c.pos_cs);
+	uint8_t outcode_a = Outcode(tri.a.pos_cs, guardBand);
+	uint8_t outcode_b = Outcode(tri.b.pos_cs, guardBand);
+	uint8_t outcode_c = Outcode(tri.c.pos_cs, guardBand);
 
 	uint8_t numInside = 0;
 	bool a_inside = false;
@@ -121,23 +137,23 @@ void ClippingEngine::ClipEdge(uint8_t edge, InterRenderTriangle& tri, InterRende
 		// Two of three inside
 		// Split triangle
 		hasSplitTri = true;
-		ClipTwoIn(edge, tri, split_tri, a_inside, b_inside, c_inside);
+		ClipTwoIn(edge, guardBand, tri, split_tri, a_inside, b_inside, c_inside);
 	}
 	else if (numInside == 1)
 	{
 		// One inside
 		// Adjust outside vertices
-		ClipOneIn(edge, tri, a_inside, b_inside, c_inside);
+		ClipOneIn(edge, guardBand, tri, a_inside, b_inside, c_inside);
 	}
 
 	return;
 }
 
-void ClippingEngine::ClipOneIn(uint8_t edge, InterRenderTriangle& tri, bool a_inside, bool b_inside, bool c_inside)
+void ClippingEngine::ClipOneIn(uint8_t edge, double guardBand, InterRenderTriangle& tri, bool a_inside, bool b_inside, bool c_inside)
 {
-	const double da = HomoDot(edge, tri.a.pos_cs);
-	const double db = HomoDot(edge, tri.b.pos_cs);
-	const double dc = HomoDot(edge, tri.c.pos_cs);
+	const double da = HomoDot(edge, tri.a.pos_cs, guardBand);
+	const double db = HomoDot(edge, tri.b.pos_cs, guardBand);
+	const double dc = HomoDot(edge, tri.c.pos_cs, guardBand);
 
 	if (a_inside)
 	{
@@ -173,11 +189,11 @@ void ClippingEngine::ClipOneIn(uint8_t edge, InterRenderTriangle& tri, bool a_in
 	return;
 }
 
-void ClippingEngine::ClipTwoIn(uint8_t edge, InterRenderTriangle& tri, InterRenderTriangle& split_tri, bool a_inside, bool b_inside, bool c_inside)
+void ClippingEngine::ClipTwoIn(uint8_t edge, double guardBand, InterRenderTriangle& tri, InterRenderTriangle& split_tri, bool a_inside, bool b_inside, bool c_inside)
 {
-	const double da = HomoDot(edge, tri.a.pos_cs);
-	const double db = HomoDot(edge, tri.b.pos_cs);
-	const double dc = HomoDot(edge, tri.c.pos_cs);
+	const double da = HomoDot(edge, tri.a.pos_cs, guardBand);
+	const double db = HomoDot(edge, tri.b.pos_cs, guardBand);
+	const double dc = HomoDot(edge, tri.c.pos_cs, guardBand);
 
 	// AB inside
 	if (!c_inside)
@@ -249,13 +265,27 @@ void ClippingEngine::ClipTwoIn(uint8_t edge, InterRenderTriangle& tri, InterRend
 	return;
 }
 
-uint8_t ClippingEngine::Outcode(const Vector4d& v)
+bool ClippingEngine::IsOutsideFrustum(const Vector4d* points, std::size_t numPoints)
+{
+	if (numPoints == 0)
+		return true;
+
+	// Planes all points lay outside of
+	uint8_t outcode = Outcode(points[0], 1.0);
+
+	for (std::size_t i = 1; (i < numPoints) && (outcode != 0); i++)
+		outcode &= Outcode(points[i], 1.0);
+
+	return outcode != 0;
+}
+
+uint8_t ClippingEngine::Outcode(const Vector4d& v, double guardBand)
 {
 	uint8_t outcode = 0;
 
 	for (uint8_t i = 0; i < 6; i++)
 	{
-		if (HomoDot(i, v) <= 0)
+		if (HomoDot(i, v, guardBand) <= 0)
 		{
 			outcode |= (1 << i);
 		}
@@ -264,17 +294,18 @@ uint8_t ClippingEngine::Outcode(const Vector4d& v)
 	return outcode;
 }
 
-double ClippingEngine::HomoDot(uint8_t edge, const Vector4d& v)
+double ClippingEngine::HomoDot(uint8_t edge, const Vector4d& v, double guardBand)
 {
+	// Only the side planes get pushed outwards. Near and far always clip for real.
 	switch (edge) {
 	case 0: // left
-		return -v.x + v.w;
+		return -v.x + v.w * guardBand;
 	case 1: // right
-		return v.x + v.w;
+		return v.x + v.w * guardBand;
 	case 2: // top
-		return -v.y + v.w;
+		return -v.y + v.w * guardBand;
 	case 3: // bottom
-		return v.y + v.w;
+		return v.y + v.w * guardBand;
 	case 4: // near
 		return v.z;
 	case 5: // far
@@ -2,11 +2,59 @@
 #include "InterRenderTriangle.h"
 #include "Vector4.h"
 #include <vector>
+#include <cstddef>
+#include <new>
+#include <type_traits>
 
 namespace TorGL
 {
+	/** Fixed-capacity, inline storage for the triangles resulting from clipping a single triangle.
+	* Lives on the stack, so clipping never touches the heap. Slots are only constructed when used.
+	*/
+	class ClippingResult
+	{
+	public:
+		//! Splitting a triangle at a plane yields at most two triangles. With six planes, that's at most \f$2^6\f$.
+		static constexpr std::size_t capacity = 64;
+
+		ClippingResult() = default;
+		ClippingResult(const ClippingResult&) = delete;
+		ClippingResult& operator=(const ClippingResult&) = delete;
+
+		//! Will append a copy of a triangle
+		void PushBack(const InterRenderTriangle& tri);
+
+		//! Will remove the triangle at index, keeping the order of all others
+		void Erase(std::size_t index);
+
+		//! Will remove all triangles
+		void Clear();
+
+		std::size_t Size() const;
+		bool Empty() const;
+
+		InterRenderTriangle& operator[](std::size_t index);
+		const InterRenderTriangle& operator[](std::size_t index) const;
+
+		InterRenderTriangle* begin();
+		InterRenderTriangle* end();
+		const InterRenderTriangle* begin() const;
+		const InterRenderTriangle* end() const;
+
+	private:
+		// Triangles never need their destructor run, so slots can just be reused and forgotten
+		static_assert(std::is_trivially_destructible<InterRenderTriangle>::value, "ClippingResult skips destructors");
+
+		alignas(InterRenderTriangle) unsigned char storage[capacity * sizeof(InterRenderTriangle)];
+		std::size_t size = 0;
+	};
+
 	/** Clips InterRenderTriangles to the clipping space.
 	*
+	* The left, right, top and bottom planes can be pushed outwards by a guard band factor. Triangles crossing the screen edges,
+	* but staying within the guard band, then pass through unsplit, and the rasterizer just skips their pixels outside of the screen.
+	* Only the near and far planes (and the guard band edges) actually split triangles.
+	*
 	* This class is used to split a single triangle into 0-n new triangles that represent the original triangle
 	* clipped inside the clipping space. This class also interpolates vertex-metadata such as normals and
 	* texture coordinates. Other data, such as material data, will be preserved.
@@ -17,23 +65,95 @@ namespace TorGL
 	class ClippingEngine
 	{
 	public:
+		//! Will clip an InterRenderTriangle into clipping space, and write the \f$[0-n]\f$ resulting triangles to result.
+		//! Triangles completely inside get passed through untouched, triangles completely outside of a single plane get dropped, without clipping anything.
+		//! guardBand scales the side planes. 1 clips exactly at the screen edges.
+		static void Clip(const InterRenderTriangle& tri, ClippingResult& result, double guardBand = 1.0);
+
 		//! Will clip an InterRenderTriangle into clipping space. May return \f$[0-n]\f$ triangles as a result
-		static std::vector<InterRenderTriangle> Clip(const InterRenderTriangle& tri);
+		static std::vector<InterRenderTriangle> Clip(const InterRenderTriangle& tri, double guardBand = 1.0);
+
+		//! Will return true, if all clipping space points lay outside of the same plane.
+		//! Pass the corners of a bounding volume to find out whether anything inside of it could possibly be visible.
+		//! Same test as the fast reject of Clip(), so a volume reported outside would only contain triangles Clip() drops anyway.
+		static bool IsOutsideFrustum(const Vector4d* points, std::size_t numPoints);
 
 	private:
 		//! Will clip an InterRenderTriangle against a single edge, or more like... plane
-		static void ClipEdge(uint8_t edge, InterRenderTriangle& tri, InterRenderTriangle& split_tri, bool& hasDroppedTri, bool& hasSplitTri);
+		static void ClipEdge(uint8_t edge, double guardBand, InterRenderTriangle& tri, InterRenderTriangle& split_tri, bool& hasDroppedTri, bool& hasSplitTri);
 
 		//! Will return a bitmap of describing the planes the homogeneous vector `v` lays outside
-		static uint8_t Outcode(const Vector4d& v);
+		static uint8_t Outcode(const Vector4d& v, double guardBand);
 
-		//! Homogeneous dot product against an edge / plane.
-		static double HomoDot(uint8_t edge, const Vector4d& v);
+		//! Homogeneous dot product against an edge / plane. The side planes are scaled by guardBand.
+		static double HomoDot(uint8_t edge, const Vector4d& v, double guardBand);
 
 		//! Specialized method to clip an InterRenderTriangle against an edge/plane, ONLY with one vertex inside.
-		static void ClipOneIn(uint8_t edge, InterRenderTriangle& tri, bool a_inside, bool b_inside, bool c_inside);
+		static void ClipOneIn(uint8_t edge, double guardBand, InterRenderTriangle& tri, bool a_inside, bool b_inside, bool c_inside);
 
 		//! Specialized method to clip an InterRenderTriangle against an edge/plane, ONLY with two vertices inside.
-		static void ClipTwoIn(uint8_t edge, InterRenderTriangle& tri, InterRenderTriangle& split_tri, bool a_inside, bool b_inside, bool c_inside);
+		static void ClipTwoIn(uint8_t edge, double guardBand, InterRenderTriangle& tri, InterRenderTriangle& split_tri, bool a_inside, bool b_inside, bool c_inside);
 	};
+
+	inline void ClippingResult::PushBack(const InterRenderTriangle& tri)
+	{
+		new (storage + size * sizeof(InterRenderTriangle)) InterRenderTriangle(tri);
+		size++;
+		return;
+	}
+
+	inline void ClippingResult::Erase(std::size_t index)
+	{
+		for (std::size_t i = index + 1; i < size; i++)
+			(*this)[i - 1] = (*this)[i];
+
+		size--;
+		return;
+	}
+
+	inline void ClippingResult::Clear()
+	{
+		size = 0;
+		return;
+	}
+
+	inline std::size_t ClippingResult::Size() const
+	{
+		return size;
+	}
+
+	inline bool ClippingResult::Empty() const
+	{
+		return size == 0;
+	}
+
+	inline InterRenderTriangle& ClippingResult::operator[](std::size_t index)
+	{
+		return begin()[index];
+	}
+
+	inline const InterRenderTriangle& ClippingResult::operator[](std::size_t index) const
+	{
+		return begin()[index];
+	}
+
+	inline InterRenderTriangle* ClippingResult::begin()
+	{
+		return std::launder(reinterpret_cast<InterRenderTriangle*>(storage));
+	}
+
+	inline InterRenderTriangle* ClippingResult::end()
+	{
+		return begin() + size;
+	}
+
+	inline const InterRenderTriangle* ClippingResult::begin() const
+	{
+		return std::launder(reinterpret_cast<const InterRenderTriangle*>(storage));
+	}
+
+	inline const InterRenderTriangle* ClippingResult::end() const
+	{
+		return begin() + size;
+	}
 }
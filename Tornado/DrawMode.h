@@ -0,0 +1,13 @@
+#pragma once
+
+namespace TorGL
+{
+	/** Describes how the DrawingEngine turns triangles into shaded pixels
+	*/
+	enum class DRAW_MODE
+	{
+		FORWARD,			// Shade every fragment passing the depth test, even if it gets overdrawn later
+		DEPTH_PREPASS,		// Only write depth first, then shade only fragments matching the final depth
+		VISIBILITY_BUFFER	// Only write depth and triangle per pixel first, then shade every visible pixel exactly once
+	};
+}
@@ -1,7 +1,9 @@
 #include "DrawingEngine.h"
-#include "BarycentricInterpolationEngine.h"
 #include "../Eule/Math.h"
 #include <cstddef>
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 using namespace TorGL;
 using namespace Eule;
@@ -14,7 +16,20 @@ DrawingEngine::DrawingEngine(PixelBuffer<3>* renderTarget, WorkerPool* workerPoo
 
 {
 	numPixels = (std::size_t)renderTarget->GetDimensions().x * (std::size_t)renderTarget->GetDimensions().y;
-	zBuffer = new double[numPixels];
+	zBuffer = new Real[numPixels];
+	visibilityBuffer = new const InterRenderTriangle*[numPixels];
+
+	// Allocate one triangle bin per screen tile
+	numTiles.x = (renderTarget->GetDimensions().x + (int)tileSize - 1) / (int)tileSize;
+	numTiles.y = (renderTarget->GetDimensions().y + (int)tileSize - 1) / (int)tileSize;
+	tileBins.resize((std::size_t)numTiles.x * (std::size_t)numTiles.y);
+	tileMaxDepth.resize(tileBins.size());
+
+	// Allocate the hierarchical z-buffer
+	numHiZCells.x = (renderTarget->GetDimensions().x + (int)hiZCellSize - 1) / (int)hiZCellSize;
+	numHiZCells.y = (renderTarget->GetDimensions().y + (int)hiZCellSize - 1) / (int)hiZCellSize;
+	hiZMin.resize((std::size_t)numHiZCells.x * (std::size_t)numHiZCells.y);
+	hiZMax.resize(hiZMin.size());
 
 	return;
 }
@@ -22,8 +37,10 @@ DrawingEngine::DrawingEngine(PixelBuffer<3>* renderTarget, WorkerPool* workerPoo
 DrawingEngine::~DrawingEngine()
 {
 	delete[] zBuffer;
+	delete[] visibilityBuffer;
 
 	zBuffer = nullptr;
+	visibilityBuffer = nullptr;
 
 	return;
 }
@@ -31,12 +48,19 @@ DrawingEngine::~DrawingEngine()
 void DrawingEngine::BeginBatch(std::size_t reservesize_triangles)
 {
 	// Clear buffers
-	std::fill_n(zBuffer, numPixels, 1000000); // Clear z-buffer
+	std::fill_n(zBuffer, numPixels, clearDepth); // Clear z-buffer
+	std::fill(hiZMin.begin(), hiZMin.end(), clearDepth);
+	std::fill(hiZMax.begin(), hiZMax.end(), clearDepth);
+	std::fill(tileMaxDepth.begin(), tileMaxDepth.end(), clearDepth);
 	renderTarget->Clear({0}); // Clear pixel buffer black
 
 	// Clear triangle registry
 	registeredTriangles.clear();
 
+	// Clear tile bins (keeps their capacity)
+	for (std::vector<const InterRenderTriangle*>& bin : tileBins)
+		bin.clear();
+
 	// Pre-allocate memory for triangles, if a size got supplied
 	if (reservesize_triangles > 0)
 		registeredTriangles.reserve(reservesize_triangles);
@@ -68,12 +92,23 @@ void DrawingEngine::HardsetInterRenderTriangles(std::vector<const InterRenderTri
 
 void DrawingEngine::Draw()
 {
-	CreateTasks();
-	ComputeTasks();
+	BinTriangles();
+	DrawTiles();
 	
 	return;
 }
 
+void DrawingEngine::SetDrawMode(DRAW_MODE mode)
+{
+	drawMode = mode;
+	return;
+}
+
+DRAW_MODE DrawingEngine::GetDrawMode() const
+{
+	return drawMode;
+}
+
 void DrawingEngine::CalculateRenderingRelatedCaches_IRD(const InterRenderTriangle* ird)
 {
 	// These normals are the meshes vertices normals!
@@ -84,181 +119,599 @@ void DrawingEngine::CalculateRenderingRelatedCaches_IRD(const InterRenderTriangl
 	return;
 }
 
-void DrawingEngine::CreateTasks()
+Rect DrawingEngine::GetScreenBounds(const InterRenderTriangle* ird) const
 {
-	// Calculate maximum screen area
-	const std::size_t totalScreenArea = (std::size_t)renderTarget->GetDimensions().x * (std::size_t)renderTarget->GetDimensions().y;
+	// Use the same sub-pixel positions as the rasterizer, so that snapping can't push a covered pixel out of the bounds
+	const double subPixelSize = 1.0 / (double)(1 << subPixelBits);
+	const double ax = (double)SnapToSubPixelGrid(ird->a.pos_ss.x) * subPixelSize;
+	const double ay = (double)SnapToSubPixelGrid(ird->a.pos_ss.y) * subPixelSize;
+	const double bx = (double)SnapToSubPixelGrid(ird->b.pos_ss.x) * subPixelSize;
+	const double by = (double)SnapToSubPixelGrid(ird->b.pos_ss.y) * subPixelSize;
+	const double cx = (double)SnapToSubPixelGrid(ird->c.pos_ss.x) * subPixelSize;
+	const double cy = (double)SnapToSubPixelGrid(ird->c.pos_ss.y) * subPixelSize;
+
+	const double minx = Math::Min(ax, Math::Min(bx, cx));
+	const double miny = Math::Min(ay, Math::Min(by, cy));
+	const double maxx = Math::Max(ax, Math::Max(bx, cx));
+	const double maxy = Math::Max(ay, Math::Max(by, cy));
+
+	// Snap to whole pixels, and clamp to the render target
+	Rect bounds;
+	bounds.pos.x = Math::Max(std::floor(minx), 0.0);
+	bounds.pos.y = Math::Max(std::floor(miny), 0.0);
+	bounds.size.x = Math::Min(std::floor(maxx), (double)renderTarget->GetDimensions().x - 1) - bounds.pos.x + 1;
+	bounds.size.y = Math::Min(std::floor(maxy), (double)renderTarget->GetDimensions().y - 1) - bounds.pos.y + 1;
+
+	return bounds;
+}
 
+void DrawingEngine::BinTriangles()
+{
 	for (const InterRenderTriangle* ird : registeredTriangles)
 	{
-		// Decide how many threads to allocate to drawing this triangle
-		const double normalizedScreenAreaPercentage = abs(ird->ss_area) / (double)totalScreenArea;
-		const double lerpedThreads = normalizedScreenAreaPercentage * (workerPool->GetNumWorkers() - 1); // f.e. 0-15
-		const std::size_t numThreadsForTriangle = std::min<std::size_t>((std::size_t)lerpedThreads + 1, 16); // would now be 1-16
-		
-		// Calculate triangle bounds, minmaxed within render area bounds
-		Rect bounds;
-		bounds.pos.x = Math::Min(ird->a.pos_ss.x, Math::Min(ird->b.pos_ss.x, ird->c.pos_ss.x));
-		bounds.pos.y = Math::Min(ird->a.pos_ss.y, Math::Min(ird->b.pos_ss.y, ird->c.pos_ss.y));
+		const Rect bounds = GetScreenBounds(ird);
+
+		// Triangle does not touch a single pixel of the render target
+		if ((bounds.size.x <= 0) || (bounds.size.y <= 0))
+			continue;
+
+		// Find the range of tiles covered by the triangles bounding box
+		const std::size_t minTileX = (std::size_t)bounds.pos.x / tileSize;
+		const std::size_t minTileY = (std::size_t)bounds.pos.y / tileSize;
+		const std::size_t maxTileX = (std::size_t)(bounds.pos.x + bounds.size.x - 1) / tileSize;
+		const std::size_t maxTileY = (std::size_t)(bounds.pos.y + bounds.size.y - 1) / tileSize;
+
+		// Bins keep registration order, so the drawing order within a tile stays the same
+		for (std::size_t ty = minTileY; ty <= maxTileY; ty++)
+			for (std::size_t tx = minTileX; tx <= maxTileX; tx++)
+				tileBins[ty * (std::size_t)numTiles.x + tx].emplace_back(ird);
+	}
 
-		bounds.size.x = Math::Max(ird->a.pos_ss.x,Math::Max(ird->b.pos_ss.x, ird->c.pos_ss.x)) - bounds.pos.x;
-		bounds.size.y = Math::Max(ird->a.pos_ss.y,Math::Max(ird->b.pos_ss.y, ird->c.pos_ss.y)) - bounds.pos.y;
+	return;
+}
 
-		// Now split this triangle into worker tasks
-		for (std::size_t i = 0; i < numThreadsForTriangle; i++)
+void DrawingEngine::DrawTiles()
+{
+	// One job per tile. The job count scales with the screen size, not the triangle count.
+	// Tiles vary wildly in cost, so hand them out one by one.
+	workerPool->ParallelFor(0, tileBins.size(), 1,
+		[this](std::size_t begin, std::size_t end)
 		{
-			// Calculate task working areas
-			const double taskSegment = bounds.size.x / numThreadsForTriangle;
-			Rect workerBounds;
-			workerBounds.pos.x = bounds.pos.x + (taskSegment * i);
-			workerBounds.pos.y = bounds.pos.y;
-			workerBounds.size.x = taskSegment;
-			workerBounds.size.y = bounds.size.y;
-
-			// Add one pixel of padding to the right (if it wouldn't cause out-of-range access)
-			// To correct floating-point in accuraccies (which would cause unrendered lines)
-			if (workerBounds.pos.x + workerBounds.size.x < renderTarget->GetDimensions().x - std::size_t(2))
-				workerBounds.size.x += 2;
-			if (workerBounds.pos.y + workerBounds.size.y < renderTarget->GetDimensions().y - std::size_t(2))
-				workerBounds.size.y += 2;
-
-			// Create new task 
-			WorkerTask* newTask = new WorkerTask; // Will be freed by the workerPool
-			newTask->task = std::bind(&DrawingEngine::Thread_Draw, this,
-				ird, workerBounds);
-			workerPool->QueueTask(newTask);
+			for (std::size_t i = begin; i < end; i++)
+				// Nothing to draw on this tile
+				if (!tileBins[i].empty())
+					Thread_DrawTile(i);
 		}
-	}
+	);
 
 	return;
 }
 
-void DrawingEngine::ComputeTasks()
+void DrawingEngine::Thread_DrawTile(std::size_t tileIndex)
 {
-	// Launch tasks
-	workerPool->Execute();
+	// Calculate the tiles pixel area. Tiles on the right and bottom edge may be cut off by the render target.
+	Rect tileBounds;
+	tileBounds.pos.x = (double)((tileIndex % (std::size_t)numTiles.x) * tileSize);
+	tileBounds.pos.y = (double)((tileIndex / (std::size_t)numTiles.x) * tileSize);
+	tileBounds.size.x = Math::Min((double)tileSize, renderTarget->GetDimensions().x - tileBounds.pos.x);
+	tileBounds.size.y = Math::Min((double)tileSize, renderTarget->GetDimensions().y - tileBounds.pos.y);
+
+	switch (drawMode)
+	{
+	case DRAW_MODE::FORWARD:
+		Thread_RasterizeTile(tileIndex, tileBounds, RASTER_PASS::SHADE);
+		break;
+
+	case DRAW_MODE::DEPTH_PREPASS:
+		Thread_RasterizeTile(tileIndex, tileBounds, RASTER_PASS::DEPTH);
+		Thread_RasterizeTile(tileIndex, tileBounds, RASTER_PASS::SHADE_EQUAL_DEPTH);
+		break;
+
+	case DRAW_MODE::VISIBILITY_BUFFER:
+	{
+		// Clear this tiles part of the visibility buffer
+		const std::size_t width = renderTarget->GetDimensions().x;
+		for (std::size_t y = (std::size_t)tileBounds.pos.y; y < (std::size_t)(tileBounds.pos.y + tileBounds.size.y); y++)
+			std::fill_n(visibilityBuffer + y * width + (std::size_t)tileBounds.pos.x, (std::size_t)tileBounds.size.x, nullptr);
+
+		Thread_RasterizeTile(tileIndex, tileBounds, RASTER_PASS::VISIBILITY);
+		Thread_ShadeVisibilityBuffer(tileBounds);
+		break;
+	}
+	}
+
 	return;
 }
 
-void DrawingEngine::Thread_Draw(const InterRenderTriangle* ird, const Rect& bounds)
+void DrawingEngine::Thread_RasterizeTile(std::size_t tileIndex, const Rect& tileBounds, RASTER_PASS pass)
 {
-	std::array<double, 5> berp_cache{ 0 };
-	const std::size_t maxx = (std::size_t)bounds.pos.x + (std::size_t)bounds.size.x;
-	const std::size_t maxy = (std::size_t)bounds.pos.y + (std::size_t)bounds.size.y;
+	const bool acceptsEqualDepth = pass == RASTER_PASS::SHADE_EQUAL_DEPTH;
 
-	for (std::size_t y = (std::size_t)bounds.pos.y; y < maxy; y++)
+	for (const InterRenderTriangle* ird : tileBins[tileIndex])
 	{
-		const std::size_t row = y * renderTarget->GetDimensions().x;
-		for (std::size_t x = (std::size_t)bounds.pos.x; x < maxx; x++)
+		// Is the whole triangle behind everything drawn to this tile so far? Depth only passes if it's strictly closer (or equal, when shading after a depth pre-pass).
+		const Real nearestDepth = (Real)Math::Min(ird->a.pos_ss.z, Math::Min(ird->b.pos_ss.z, ird->c.pos_ss.z));
+		if ((nearestDepth > tileMaxDepth[tileIndex]) || ((nearestDepth == tileMaxDepth[tileIndex]) && !acceptsEqualDepth))
+			continue;
+
+		const Rect triangleBounds = GetScreenBounds(ird);
+
+		// Intersect the triangles bounding box with this tile
+		Rect bounds;
+		bounds.pos.x = Math::Max(triangleBounds.pos.x, tileBounds.pos.x);
+		bounds.pos.y = Math::Max(triangleBounds.pos.y, tileBounds.pos.y);
+		bounds.size.x = Math::Min(triangleBounds.pos.x + triangleBounds.size.x, tileBounds.pos.x + tileBounds.size.x) - bounds.pos.x;
+		bounds.size.y = Math::Min(triangleBounds.pos.y + triangleBounds.size.y, tileBounds.pos.y + tileBounds.size.y) - bounds.pos.y;
+
+		Thread_Draw(ird, tileIndex, bounds, pass);
+	}
+
+	return;
+}
+
+void DrawingEngine::Thread_ShadeVisibilityBuffer(const Rect& tileBounds)
+{
+	const long minx = (long)tileBounds.pos.x;
+	const long miny = (long)tileBounds.pos.y;
+	const long maxx = minx + (long)tileBounds.size.x - 1;
+	const long maxy = miny + (long)tileBounds.size.y - 1;
+	const std::size_t width = renderTarget->GetDimensions().x;
+
+	PixelBlock block;
+	std::array<const InterRenderTriangle*, blockLanes> laneTriangles;
+
+	// Every lane we shade has already passed the depth test. We only need the kernels weights.
+	std::array<Real, blockLanes> depth;
+	depth.fill(std::numeric_limits<Real>::infinity());
+
+	// Neighbouring blocks mostly show the same triangle. Only set it up again when it changes.
+	TriangleSetup setup;
+	const InterRenderTriangle* setupTriangle = nullptr;
+
+	// Tiles are aligned to blocks
+	for (long y = miny; y <= maxy; y += (long)blockHeight)
+		for (long x = minx; x <= maxx; x += (long)blockWidth)
 		{
-			if ((x > 0) && (y > 0) && (x < renderTarget->GetDimensions().x) && (y < renderTarget->GetDimensions().y))
+			// Fetch the visible triangle of every lane
+			for (std::size_t lane = 0; lane < blockLanes; lane++)
 			{
-				Vector2d pixelPosition((double)x, (double)y);
-				if (ird->DoesScreenspaceContainPoint(pixelPosition))
-				{
-					std::size_t pixelIndex = (row + x) * renderTarget->GetChannelWidth();
-					uint8_t* basePixel = renderTarget->GetRawData() + pixelIndex;
-
-					berp_cache[0] = 0;
-					const double z = BarycentricInterpolationEngine::PerspectiveCorrect__CachedValues(
-						*ird,
-						pixelPosition,
-						ird->a.pos_ss.z,
-						ird->b.pos_ss.z,
-						ird->c.pos_ss.z,
-						&berp_cache
-					);
-
-					double& zBuf = zBuffer[x + y * renderTarget->GetDimensions().x];
-					if (z < zBuf)
+				const long px = x + (long)(lane % blockWidth);
+				const long py = y + (long)(lane / blockWidth);
+
+				if ((px > maxx) || (py > maxy))
+					laneTriangles[lane] = nullptr;
+				else
+					laneTriangles[lane] = visibilityBuffer[(std::size_t)py * width + (std::size_t)px];
+			}
+
+			// Shade all lanes showing the same triangle at once
+			for (std::size_t firstLane = 0; firstLane < blockLanes; firstLane++)
+			{
+				const InterRenderTriangle* ird = laneTriangles[firstLane];
+				if (ird == nullptr)
+					continue;
+
+				uint8_t laneMask = 0;
+				for (std::size_t lane = firstLane; lane < blockLanes; lane++)
+					if (laneTriangles[lane] == ird)
 					{
-                        // Only fill in the zbuffer value, if a pixel was actually rendered.
-                        // Cases in which no pixel gets rendered by Thread__PixelShader might be when its texture marks it as transparent...
-						if (Thread_PixelShader(ird, basePixel, pixelPosition, &berp_cache, z)) {
-						    zBuf = z;
-                        }
+						laneMask |= (uint8_t)(1 << lane);
+						laneTriangles[lane] = nullptr;
 					}
+
+				if (ird != setupTriangle)
+				{
+					setup = SetupTriangle(ird);
+					setupTriangle = ird;
+				}
+
+				RasterizeBlock(setup, x, y, depth, block);
+				InterpolateBlock(setup, block);
+
+				for (std::size_t lane = 0; lane < blockLanes; lane++)
+				{
+					if (!(laneMask & (1 << lane)))
+						continue;
+
+					const std::size_t pixelIndex = (std::size_t)(y + (long)(lane / blockWidth)) * width + (std::size_t)(x + (long)(lane % blockWidth));
+					uint8_t* basePixel = renderTarget->GetRawData() + pixelIndex * renderTarget->GetChannelWidth();
+
+					// Transparent texels have already been rejected when writing the visibility buffer
+					Thread_PixelShader(ird, basePixel, block, lane);
 				}
 			}
 		}
+
+	return;
+}
+
+void DrawingEngine::Thread_UpdateHiZ(std::size_t tileIndex, const Vector2i& firstCell, uint32_t dirtyCells)
+{
+	const std::size_t width = renderTarget->GetDimensions().x;
+	const std::size_t height = renderTarget->GetDimensions().y;
+
+	for (std::size_t i = 0; i < cellsPerTileRow * cellsPerTileRow; i++)
+	{
+		if (!(dirtyCells & (1u << i)))
+			continue;
+
+		const std::size_t cx = (std::size_t)firstCell.x + (i % cellsPerTileRow);
+		const std::size_t cy = (std::size_t)firstCell.y + (i / cellsPerTileRow);
+
+		// Cells on the right and bottom edge may be cut off by the render target
+		const std::size_t endX = std::min((cx + 1) * hiZCellSize, width);
+		const std::size_t endY = std::min((cy + 1) * hiZCellSize, height);
+
+		Real farthest = 0;
+		for (std::size_t y = cy * hiZCellSize; y < endY; y++)
+			for (std::size_t x = cx * hiZCellSize; x < endX; x++)
+				farthest = (Real)Math::Max(farthest, zBuffer[y * width + x]);
+
+		hiZMax[cy * (std::size_t)numHiZCells.x + cx] = farthest;
 	}
 
+	// Propagate to the tile level
+	const std::size_t firstTileCellX = (tileIndex % (std::size_t)numTiles.x) * cellsPerTileRow;
+	const std::size_t firstTileCellY = (tileIndex / (std::size_t)numTiles.x) * cellsPerTileRow;
+	const std::size_t endCellX = std::min(firstTileCellX + cellsPerTileRow, (std::size_t)numHiZCells.x);
+	const std::size_t endCellY = std::min(firstTileCellY + cellsPerTileRow, (std::size_t)numHiZCells.y);
+
+	Real farthest = 0;
+	for (std::size_t cy = firstTileCellY; cy < endCellY; cy++)
+		for (std::size_t cx = firstTileCellX; cx < endCellX; cx++)
+			farthest = (Real)Math::Max(farthest, hiZMax[cy * (std::size_t)numHiZCells.x + cx]);
+
+	tileMaxDepth[tileIndex] = farthest;
+
 	return;
 }
 
-bool DrawingEngine::Thread_PixelShader(const InterRenderTriangle* ird, uint8_t* pixelBase, const Vector2d& pixelPosition, std::array<double, 5>* berp_cache, double z)
+int64_t DrawingEngine::SnapToSubPixelGrid(double v)
+{
+	return (int64_t)std::llround(v * (double)(1 << subPixelBits));
+}
+
+DrawingEngine::EdgeEquation DrawingEngine::SetupEdgeEquation(int64_t fromX, int64_t fromY, int64_t toX, int64_t toY)
+{
+	// Same edge function as InterRenderTriangle::DoesScreenspaceContainPoint(), just rearranged
+	// to a*x + b*y + c, so that it can be stepped by adding a (per pixel) and b (per row).
+	// Everything is in sub-pixel units, except for a and b being scaled to whole pixel steps.
+	const int64_t dy = toY - fromY;
+	const int64_t dx = fromX - toX;
+
+	EdgeEquation edge;
+	edge.a = dy * (1 << subPixelBits);
+	edge.b = dx * (1 << subPixelBits);
+	edge.c = -(fromX * dy) - (fromY * dx);
+
+	// Left edges have the inside to their right. Top edges are horizontal, with the inside below.
+	const bool isTopLeft = (dy > 0) || ((dy == 0) && (dx > 0));
+	edge.minValue = isTopLeft ? 0 : 1;
+
+	return edge;
+}
+
+DrawingEngine::TriangleSetup DrawingEngine::SetupTriangle(const InterRenderTriangle* ird)
+{
+	TriangleSetup setup;
+
+	// Snap to the sub-pixel grid
+	const int64_t ax = SnapToSubPixelGrid(ird->a.pos_ss.x);
+	const int64_t ay = SnapToSubPixelGrid(ird->a.pos_ss.y);
+	const int64_t bx = SnapToSubPixelGrid(ird->b.pos_ss.x);
+	const int64_t by = SnapToSubPixelGrid(ird->b.pos_ss.y);
+	const int64_t cx = SnapToSubPixelGrid(ird->c.pos_ss.x);
+	const int64_t cy = SnapToSubPixelGrid(ird->c.pos_ss.y);
+
+	// Edge i is opposite to vertex i
+	setup.edges = {
+		SetupEdgeEquation(cx, cy, bx, by),
+		SetupEdgeEquation(ax, ay, cx, cy),
+		SetupEdgeEquation(bx, by, ax, ay)
+	};
+
+	for (std::size_t e = 0; e < 3; e++)
+		for (std::size_t lane = 0; lane < blockLanes; lane++)
+			setup.laneOffsets[e][lane] =
+				(setup.edges[e].a * (int64_t)(lane % blockWidth)) +
+				(setup.edges[e].b * (int64_t)(lane / blockWidth));
+
+	const InterRenderVertex* vertices[3] = { &ird->a, &ird->b, &ird->c };
+	for (std::size_t i = 0; i < 3; i++)
+	{
+		const InterRenderVertex& v = *vertices[i];
+
+		// Same weights as in BarycentricInterpolationEngine::PerspectiveCorrect__CachedValues()
+		setup.perspectiveWeights[i] = (Real)(ird->ss_iarea / (v.pos_cs.z + 1));
+		setup.z[i] = (Real)v.pos_ss.z;
+
+		setup.attributes[0][i] = (Real)v.pos_uv.x;
+		setup.attributes[1][i] = (Real)v.pos_uv.y;
+		setup.attributes[2][i] = (Real)v.pos_ws.x;
+		setup.attributes[3][i] = (Real)v.pos_ws.y;
+		setup.attributes[4][i] = (Real)v.pos_ws.z;
+		setup.attributes[5][i] = (Real)v.normal.x;
+		setup.attributes[6][i] = (Real)v.normal.y;
+		setup.attributes[7][i] = (Real)v.normal.z;
+	}
+
+	return setup;
+}
+
+bool DrawingEngine::FindRowSpan(const TriangleSetup& setup, double y, double minx, double maxx, double& begin, double& end)
+{
+	begin = minx;
+	end = maxx;
+
+	// Every edge function is linear in x, so each one limits the span to one side
+	for (const EdgeEquation& edge : setup.edges)
+	{
+		const double valueAtMinx = ((double)edge.a * minx) + ((double)edge.b * y) + (double)edge.c;
+
+		if (edge.a > 0)
+			begin = Math::Max(begin, minx - valueAtMinx / (double)edge.a);
+		else if (edge.a < 0)
+			end = Math::Min(end, minx - valueAtMinx / (double)edge.a);
+		else if (valueAtMinx < 0)
+			return false;
+	}
+
+	// Widen the span by one pixel on each side. The exact per-pixel test is what actually decides.
+	// This just keeps floating point inaccuracies from cutting off edge pixels.
+	begin = Math::Max(std::floor(begin) - 1, minx);
+	end = Math::Min(std::ceil(end) + 1, maxx);
+
+	return begin <= end;
+}
+
+void DrawingEngine::Thread_Draw(const InterRenderTriangle* ird, std::size_t tileIndex, const Rect& bounds, RASTER_PASS pass)
+{
+	// Bounds are already clipped to the render target by the caller. No need to check them per pixel.
+	if ((bounds.size.x <= 0) || (bounds.size.y <= 0))
+		return;
+
+	const long minx = (long)bounds.pos.x;
+	const long miny = (long)bounds.pos.y;
+	const long maxx = minx + (long)bounds.size.x - 1;
+	const long maxy = miny + (long)bounds.size.y - 1;
+	const std::size_t width = renderTarget->GetDimensions().x;
+
+	// Set up the edge functions and interpolation constants once per triangle
+	const TriangleSetup setup = SetupTriangle(ird);
+
+	// Depth range of the triangle. Interpolated depths never leave it.
+	const Real nearestDepth = (Real)Math::Min(setup.z[0], Math::Min(setup.z[1], setup.z[2]));
+	const Real farthestDepth = (Real)Math::Max(setup.z[0], Math::Max(setup.z[1], setup.z[2]));
+
+	// After a depth pre-pass, the z-buffer already holds the final depths. Fragments matching them exactly pass.
+	const bool acceptsEqualDepth = pass == RASTER_PASS::SHADE_EQUAL_DEPTH;
+
+	// Hierarchical z-buffer cells written to by this triangle, relative to the first cell within bounds
+	const Vector2i firstCell((int)(minx / (long)hiZCellSize), (int)(miny / (long)hiZCellSize));
+	uint32_t dirtyCells = 0;
+
+	PixelBlock block;
+	std::array<Real, blockLanes> depth;
+	bool hasDrawnSpan = false;
+
+	// Blocks are aligned to multiples of their size. The tile size is a multiple of it too, so a block never spans two tiles.
+	for (long y = miny - (miny % (long)blockHeight); y <= maxy; y += (long)blockHeight)
+	{
+		// Find the span covered by any row of this block row
+		double spanBegin = (double)maxx + 1;
+		double spanEnd = (double)minx - 1;
+		for (long row = Math::Max(y, miny); row <= Math::Min(y + (long)blockHeight - 1, maxy); row++)
+		{
+			double rowBegin;
+			double rowEnd;
+			if (FindRowSpan(setup, (double)row, (double)minx, (double)maxx, rowBegin, rowEnd))
+			{
+				spanBegin = Math::Min(spanBegin, rowBegin);
+				spanEnd = Math::Max(spanEnd, rowEnd);
+			}
+		}
+
+		if (spanBegin > spanEnd)
+		{
+			// Triangles are convex. Once we've left them, no further row can be covered.
+			if (hasDrawnSpan)
+				break;
+
+			continue;
+		}
+		hasDrawnSpan = true;
+
+		const long spanBeginX = (long)spanBegin;
+		for (long x = spanBeginX - (spanBeginX % (long)blockWidth); x <= (long)spanEnd; x += (long)blockWidth)
+		{
+			// Blocks never span two cells
+			const std::size_t cellX = (std::size_t)x / hiZCellSize;
+			const std::size_t cellY = (std::size_t)y / hiZCellSize;
+			const std::size_t cellIndex = cellY * (std::size_t)numHiZCells.x + cellX;
+
+			// Is the whole triangle behind everything in this cell?
+			if ((nearestDepth > hiZMax[cellIndex]) || ((nearestDepth == hiZMax[cellIndex]) && !acceptsEqualDepth))
+				continue;
+
+			// Is the whole triangle in front of everything in this cell? Then we don't have to read the z-buffer at all.
+			const bool isInFront = (farthestDepth < hiZMin[cellIndex]) && !acceptsEqualDepth;
+
+			// Fetch the depth buffer values of this block. Lanes outside of the bounds can never pass the depth test.
+			for (std::size_t lane = 0; lane < blockLanes; lane++)
+			{
+				const long px = x + (long)(lane % blockWidth);
+				const long py = y + (long)(lane / blockWidth);
+
+				if ((px < minx) || (px > maxx) || (py < miny) || (py > maxy))
+					depth[lane] = -std::numeric_limits<Real>::infinity();
+				else if (isInFront)
+					depth[lane] = std::numeric_limits<Real>::infinity();
+				else if (acceptsEqualDepth)
+					depth[lane] = std::nextafter(zBuffer[(std::size_t)py * width + (std::size_t)px], std::numeric_limits<Real>::infinity());
+				else
+					depth[lane] = zBuffer[(std::size_t)py * width + (std::size_t)px];
+			}
+
+			const uint8_t laneMask = RasterizeBlock(setup, x, y, depth, block);
+			if (laneMask == 0)
+				continue;
+
+			InterpolateBlock(setup, block);
+
+			for (std::size_t lane = 0; lane < blockLanes; lane++)
+			{
+				if (!(laneMask & (1 << lane)))
+					continue;
+
+				const std::size_t pixelIndex = (std::size_t)(y + (long)(lane / blockWidth)) * width + (std::size_t)(x + (long)(lane % blockWidth));
+				uint8_t* basePixel = renderTarget->GetRawData() + pixelIndex * renderTarget->GetChannelWidth();
+
+				// Only fill in the zbuffer value, if a pixel was actually rendered.
+				// Cases in which no pixel gets rendered by Thread__PixelShader might be when its texture marks it as transparent...
+				bool isDrawn = false;
+				switch (pass)
+				{
+				case RASTER_PASS::SHADE:
+					isDrawn = Thread_PixelShader(ird, basePixel, block, lane);
+					break;
+
+				case RASTER_PASS::DEPTH:
+					isDrawn = !IsTransparent(ird, block, lane);
+					break;
+
+				case RASTER_PASS::SHADE_EQUAL_DEPTH:
+					// Just like in the forward pass, the first triangle at this depth wins.
+					// Nudge the stored depth to keep later triangles at the very same depth from shading it again.
+					if (Thread_PixelShader(ird, basePixel, block, lane))
+						zBuffer[pixelIndex] = std::nextafter(block.z[lane], -std::numeric_limits<Real>::infinity());
+					break;
+
+				case RASTER_PASS::VISIBILITY:
+					isDrawn = !IsTransparent(ird, block, lane);
+					if (isDrawn)
+						visibilityBuffer[pixelIndex] = ird;
+					break;
+				}
+
+				if (isDrawn)
+				{
+					zBuffer[pixelIndex] = block.z[lane];
+					hiZMin[cellIndex] = (Real)Math::Min(hiZMin[cellIndex], block.z[lane]);
+					dirtyCells |= 1u << (((cellY - (std::size_t)firstCell.y) * cellsPerTileRow) + (cellX - (std::size_t)firstCell.x));
+				}
+			}
+		}
+	}
+
+	// Pixels got closer. The farthest depth of the cells they are in (and their tile) might have, too.
+	if (dirtyCells != 0)
+		Thread_UpdateHiZ(tileIndex, firstCell, dirtyCells);
+
+	return;
+}
+
+uint8_t DrawingEngine::RasterizeBlock(const TriangleSetup& setup, long x, long y, const std::array<Real, blockLanes>& depthBuffer, PixelBlock& block)
+{
+	// Evaluate the edge functions exactly, in fixed point. Once at the block origin, then just add the lane offsets.
+	std::array<std::array<int64_t, blockLanes>, 3> edgeValues;
+	for (std::size_t e = 0; e < 3; e++)
+	{
+		const EdgeEquation& edge = setup.edges[e];
+		const int64_t originValue = (edge.a * (int64_t)x) + (edge.b * (int64_t)y) + edge.c;
+
+		for (std::size_t lane = 0; lane < blockLanes; lane++)
+			edgeValues[e][lane] = originValue + setup.laneOffsets[e][lane];
+	}
+
+	uint8_t laneMask = 0;
+	for (std::size_t lane = 0; lane < blockLanes; lane++)
+	{
+		// Perspective correct barycentric weights
+		const Real w0 = (Real)edgeValues[0][lane] * setup.perspectiveWeights[0];
+		const Real w1 = (Real)edgeValues[1][lane] * setup.perspectiveWeights[1];
+		const Real w2 = (Real)edgeValues[2][lane] * setup.perspectiveWeights[2];
+		const Real iws = Real(1) / (w0 + w1 + w2); // Pre-calculate division
+
+		block.weights[0][lane] = w0 * iws;
+		block.weights[1][lane] = w1 * iws;
+		block.weights[2][lane] = w2 * iws;
+
+		block.z[lane] =
+			(block.weights[0][lane] * setup.z[0]) +
+			(block.weights[1][lane] * setup.z[1]) +
+			(block.weights[2][lane] * setup.z[2]);
+
+		// Coverage (with the top-left fill rule) and depth test in one go
+		const bool passes =
+			(edgeValues[0][lane] >= setup.edges[0].minValue) &
+			(edgeValues[1][lane] >= setup.edges[1].minValue) &
+			(edgeValues[2][lane] >= setup.edges[2].minValue) &
+			(block.z[lane] < depthBuffer[lane]);
+
+		laneMask |= (uint8_t)passes << lane;
+	}
+
+	return laneMask;
+}
+
+void DrawingEngine::InterpolateBlock(const TriangleSetup& setup, PixelBlock& block)
+{
+	for (std::size_t i = 0; i < numInterpolatedAttributes; i++)
+		for (std::size_t lane = 0; lane < blockLanes; lane++)
+			block.attributes[i][lane] =
+				(block.weights[0][lane] * setup.attributes[i][0]) +
+				(block.weights[1][lane] * setup.attributes[i][1]) +
+				(block.weights[2][lane] * setup.attributes[i][2]);
+
+	return;
+}
+
+uint8_t* DrawingEngine::SampleTexture(const Material* material, const PixelBlock& block, std::size_t lane)
 {
 	Vector2d uv_coords(
-		BarycentricInterpolationEngine::PerspectiveCorrect__CachedValues(
-			*ird,
-			pixelPosition,
-			ird->a.pos_uv.x,
-			ird->b.pos_uv.x,
-			ird->c.pos_uv.x,
-			berp_cache
-		),
-		BarycentricInterpolationEngine::PerspectiveCorrect__CachedValues(
-			*ird,
-			pixelPosition,
-			ird->a.pos_uv.y,
-			ird->b.pos_uv.y,
-			ird->c.pos_uv.y,
-			berp_cache
-		)
+		block.attributes[0][lane],
+		block.attributes[1][lane]
 	);
 
-	Vector3d ws_coords(
-		BarycentricInterpolationEngine::PerspectiveCorrect__CachedValues(
-			*ird,
-			pixelPosition,
-			ird->a.pos_ws.x,
-			ird->b.pos_ws.x,
-			ird->c.pos_ws.x,
-			berp_cache
-		),
-		BarycentricInterpolationEngine::PerspectiveCorrect__CachedValues(
-			*ird,
-			pixelPosition,
-			ird->a.pos_ws.y,
-			ird->b.pos_ws.y,
-			ird->c.pos_ws.y,
-			berp_cache
-		),
-		BarycentricInterpolationEngine::PerspectiveCorrect__CachedValues(
-			*ird,
-			pixelPosition,
-			ird->a.pos_ws.z,
-			ird->b.pos_ws.z,
-			ird->c.pos_ws.z,
-			berp_cache
-		)
+	Vector2d text_size(
+		material->texture->GetPixelBuffer().GetDimensions().x,
+		material->texture->GetPixelBuffer().GetDimensions().y
+	);
+
+    // Scale uv coords to texture space
+    uv_coords.x *= (text_size.x);
+    uv_coords.y *= (text_size.y);
+
+    uv_coords.y = (text_size.y) - uv_coords.y;
+
+    // Modulo them to the texture space (it seems like they should repeat, if they're out-of-bounds?!)
+    uv_coords.x = Math::Mod(uv_coords.x, text_size.x - 1);
+    uv_coords.y = Math::Mod(uv_coords.y, text_size.y - 1);
+
+	return material->texture->GetPixelBuffer().GetPixel(uv_coords.ToInt());
+}
+
+bool DrawingEngine::IsTransparent(const InterRenderTriangle* ird, const PixelBlock& block, std::size_t lane)
+{
+	// Only textures can be transparent
+	if (ird->material == nullptr)
+		return false;
+
+	return SampleTexture(ird->material, block, lane)[3] == 0;
+}
+
+bool DrawingEngine::Thread_PixelShader(const InterRenderTriangle* ird, uint8_t* pixelBase, const PixelBlock& block, std::size_t lane)
+{
+	const Vector3d ws_coords(
+		block.attributes[2][lane],
+		block.attributes[3][lane],
+		block.attributes[4][lane]
 	);
 
-	Vector3d smooth_normal(
-		BarycentricInterpolationEngine::PerspectiveCorrect__CachedValues(
-			*ird,
-			pixelPosition,
-			ird->a.normal.x,
-			ird->b.normal.x,
-			ird->c.normal.x,
-			berp_cache
-		),
-		BarycentricInterpolationEngine::PerspectiveCorrect__CachedValues(
-			*ird,
-			pixelPosition,
-			ird->a.normal.y,
-			ird->b.normal.y,
-			ird->c.normal.y,
-			berp_cache
-		),
-		BarycentricInterpolationEngine::PerspectiveCorrect__CachedValues(
-			*ird,
-			pixelPosition,
-			ird->a.normal.z,
-			ird->b.normal.z,
-			ird->c.normal.z,
-			berp_cache
-		)
+	const Vector3d smooth_normal(
+		block.attributes[5][lane],
+		block.attributes[6][lane],
+		block.attributes[7][lane]
 	);
 
 	uint8_t& r = pixelBase[0];
@@ -268,23 +721,14 @@ bool DrawingEngine::Thread_PixelShader(const InterRenderTriangle* ird, uint8_t*
 	// Do we have a material?
 	if (ird->material != nullptr)
 	{
-		Vector2d text_size(
-			ird->material->texture->GetPixelBuffer().GetDimensions().x,
-			ird->material->texture->GetPixelBuffer().GetDimensions().y
-		);
-
-        // Scale uv coords to texture space
-        uv_coords.x *= (text_size.x);
-        uv_coords.y *= (text_size.y);
-
-        uv_coords.y = (text_size.y) - uv_coords.y;
+		const uint8_t* text_pixel = SampleTexture(ird->material, block, lane);
 
-        // Modulo them to the texture space (it seems like they should repeat, if they're out-of-bounds?!)
-        uv_coords.x = Math::Mod(uv_coords.x, text_size.x - 1);
-        uv_coords.y = Math::Mod(uv_coords.y, text_size.y - 1);
+        // Is the pixel marked as transparent?
+        // If yes, don't render it.
+        if (text_pixel[3] == 0) {
+            return false;
+        }
 
-		uint8_t* text_pixel = ird->material->texture->GetPixelBuffer().GetPixel(uv_coords.ToInt());
-		
 		// Calculate brightness (if we should shade)
 		Color brightness = Color(1,1,1);
 		if (!ird->material->noShading)
@@ -303,12 +747,6 @@ bool DrawingEngine::Thread_PixelShader(const InterRenderTriangle* ird, uint8_t*
 			brightness.b += Math::Min(brightness.b + globalIllumination, 1.0);
 		}
 
-        // Is the pixel marked as transparent?
-        // If yes, don't render it.
-        if (text_pixel[3] == 0) {
-            return false;
-        }
-
 		r = uint8_t(Math::Clamp((double)text_pixel[0] * brightness.r, 0, 255));
 		g = uint8_t(Math::Clamp((double)text_pixel[1] * brightness.g, 0, 255));
 		b = uint8_t(Math::Clamp((double)text_pixel[2] * brightness.b, 0, 255));
@@ -3,7 +3,12 @@
 #include "WorkerPool.h"
 #include "InterRenderTriangle.h"
 #include "LightingEngine.h"
+#include "SimdDispatch.h"
+#include "Precision.h"
+#include "DrawMode.h"
 #include "../Eule/Rect.h"
+#include <array>
+#include <cstdint>
 
 namespace TorGL
 {
@@ -29,30 +34,166 @@ namespace TorGL
 		//! Will freeze the main (calling) thread, until the drawing has been finished.
 		void Draw();
 
+		//! Will set how triangles get drawn. Takes effect with the next call to Draw().
+		void SetDrawMode(DRAW_MODE mode);
+
+		//! Will return how triangles get drawn
+		DRAW_MODE GetDrawMode() const;
+
 	private:
 		//! Will calculate cached values that only need to be calculated once ber InterRenderTriangle.
 		//! Call before running its compute task!!
 		void CalculateRenderingRelatedCaches_IRD(const InterRenderTriangle* ird);
 
-		//! Will distribute drawing tasks based on a triangles screen size
-		void CreateTasks();
+		//! Will return a triangles bounding box in whole pixels, clamped to the render target.  
+		//! The size will be <= 0 if the triangle does not cover the render target at all.
+		Eule::Rect GetScreenBounds(const InterRenderTriangle* ird) const;
+
+		//! Will sort all registered triangles into the screen tiles their bounding boxes overlap
+		void BinTriangles();
+
+		//! Will draw all tiles that have triangles binned to them, in parallel
+		void DrawTiles();
+
+		//! Task method. Will draw all triangles binned to a tile, in registration order.
+		//! A tile is only ever drawn by a single task, so it has exclusive access to its pixels and z-buffer values.
+		void Thread_DrawTile(std::size_t tileIndex);
+
+		//! What a rasterization pass writes for fragments passing the depth test
+		enum class RASTER_PASS
+		{
+			SHADE,				// Shade the fragment right away
+			DEPTH,				// Only write depth
+			SHADE_EQUAL_DEPTH,	// Shade the fragment, if it's exactly as far as the stored depth. Writes no depth.
+			VISIBILITY			// Only write the triangle to the visibility buffer
+		};
+
+		//! Will run one rasterization pass over all triangles binned to a tile
+		void Thread_RasterizeTile(std::size_t tileIndex, const Eule::Rect& tileBounds, RASTER_PASS pass);
+
+		//! Main drawing method. Will rasterize a triangle, restricted to a pixel rectangle within a tile.
+		//! Pixels are processed in blocks of blockWidth x blockHeight, through RasterizeBlock() and InterpolateBlock().
+		//! Blocks entirely behind the hierarchical z-buffer get skipped.
+		void Thread_Draw(const InterRenderTriangle* ird, std::size_t tileIndex, const Eule::Rect& bounds, RASTER_PASS pass);
+
+		//! Will shade every pixel of a tile exactly once, with the triangle stored in the visibility buffer
+		void Thread_ShadeVisibilityBuffer(const Eule::Rect& tileBounds);
+
+		//! Number of fractional bits screen space vertex positions get snapped to
+		static constexpr int subPixelBits = 8;
+
+		//! Will snap a screen space coordinate to the sub-pixel grid, in sub-pixel units
+		static int64_t SnapToSubPixelGrid(double v);
+
+		//! A fixed point edge function in the form \f$a*x + b*y + c\f$, with x and y in whole pixels. Positive on the inner side of the edge.
+		//! Being exact integers, two triangles sharing an edge always agree on which side of it a pixel is.
+		struct EdgeEquation
+		{
+			int64_t a;
+			int64_t b;
+			int64_t c;
+
+			//! Smallest value a covered pixel may have. 0 for top and left edges, 1 for all others (top-left fill rule).
+			//! This way, pixels exactly on an edge shared by two triangles get drawn by only one of them.
+			int64_t minValue;
+		};
+
+		//! Will set up the edge function of a screen space edge, from vertices snapped to the sub-pixel grid
+		static EdgeEquation SetupEdgeEquation(int64_t fromX, int64_t fromY, int64_t toX, int64_t toY);
+
+		//! Number of pixels in a block. One AVX2 register worth of Reals: 2x2 pixels in double precision, 4x2 pixels in single precision.
+		static constexpr std::size_t blockLanes = 32 / sizeof(Real);
+		static constexpr std::size_t blockHeight = 2;
+		static constexpr std::size_t blockWidth = blockLanes / blockHeight;
+
+		//! Number of vertex attributes interpolated per pixel (uv: 2, world space position: 3, normal: 3)
+		static constexpr std::size_t numInterpolatedAttributes = 8;
+
+		//! Everything about a triangle the block kernels need, set up once per triangle.
+		//! Index i of edges, perspectiveWeights and the attribute arrays always belongs to vertex a, b, c (in that order).
+		//! edges[i] is the edge opposite to vertex i. Evaluated at a pixel, it is vertex i's (unnormalized) barycentric weight.
+		struct TriangleSetup
+		{
+			std::array<EdgeEquation, 3> edges;
+			std::array<std::array<int64_t, blockLanes>, 3> laneOffsets; //! Edge value offset of each lane from its blocks origin
+			std::array<Real, 3> perspectiveWeights; //! 1 over w per vertex (times the inverted area), to make interpolation perspective correct
+			std::array<Real, 3> z;
+			std::array<std::array<Real, 3>, numInterpolatedAttributes> attributes;
+		};
 
-		//! Will execute the tasks
-		void ComputeTasks();
+		//! Per-pixel values of a pixel block, one lane per pixel, row-major.
+		struct PixelBlock
+		{
+			std::array<std::array<Real, blockLanes>, 3> weights; //! Perspective correct barycentric weights of a, b, c
+			std::array<Real, blockLanes> z;
+			std::array<std::array<Real, blockLanes>, numInterpolatedAttributes> attributes;
+		};
 
-		//! Main drawing method for the tasks
-		void Thread_Draw(const InterRenderTriangle* ird, const Eule::Rect& bounds);
+		//! Will set up a triangle for the block kernels
+		static TriangleSetup SetupTriangle(const InterRenderTriangle* ird);
 
-		//! Will draw a single pixel. Returns false, if now pixel was drawn (like, when its texture marks it as transparent.)
-		bool Thread_PixelShader(const InterRenderTriangle* ird, uint8_t* pixelBase, const Vector2d& pixelPosition, std::array<double, 5>* berp_cache, double z);
+		//! Will find the pixel range [begin, end] of row y, within [minx, maxx], that may be covered by a triangle. Returns false if nothing is covered.
+		static bool FindRowSpan(const TriangleSetup& setup, double y, double minx, double maxx, double& begin, double& end);
+
+		//! Block kernel. Will compute coverage, perspective correct barycentric weights and depth of the block at (x, y), and depth-test it against depthBuffer.
+		//! Returns a bitmask of lanes that are covered and closer than their depthBuffer value.
+		TORGL_SIMD_CLONES static uint8_t RasterizeBlock(const TriangleSetup& setup, long x, long y, const std::array<Real, blockLanes>& depthBuffer, PixelBlock& block);
+
+		//! Block kernel. Will interpolate all vertex attributes for all lanes of a block, with the weights computed by RasterizeBlock().
+		TORGL_SIMD_CLONES static void InterpolateBlock(const TriangleSetup& setup, PixelBlock& block);
+
+		//! Will recompute the farthest depth of all hierarchical z-buffer cells in dirtyCells, and of the tile containing them.
+		//! dirtyCells is a bitmask of cells, relative to firstCell, with cellsPerTileRow cells per row.
+		void Thread_UpdateHiZ(std::size_t tileIndex, const Vector2i& firstCell, uint32_t dirtyCells);
+
+		//! Will return the texel of a materials texture at a lanes uv coordinates
+		static uint8_t* SampleTexture(const Material* material, const PixelBlock& block, std::size_t lane);
+
+		//! Will return whether a triangles texture marks a lane as transparent
+		static bool IsTransparent(const InterRenderTriangle* ird, const PixelBlock& block, std::size_t lane);
+
+		//! Will draw a single pixel (lane) of a block. Returns false, if now pixel was drawn (like, when its texture marks it as transparent.)
+		bool Thread_PixelShader(const InterRenderTriangle* ird, uint8_t* pixelBase, const PixelBlock& block, std::size_t lane);
 
 		WorkerPool* workerPool;
 		PixelBuffer<3>* renderTarget;
 
-		double* zBuffer;
+		Real* zBuffer;
 		std::size_t numPixels;
+
+		//! Frontmost triangle per pixel. Only written in DRAW_MODE::VISIBILITY_BUFFER.
+		const InterRenderTriangle** visibilityBuffer;
+
+		DRAW_MODE drawMode = DRAW_MODE::FORWARD;
 		std::vector<const InterRenderTriangle*> registeredTriangles;
 
+		//! Edge length (in pixels) of the square screen tiles triangles get binned into
+		static constexpr std::size_t tileSize = 32;
+
+		//! Number of tiles per row and column
+		Vector2i numTiles;
+
+		//! One bin of triangles per tile, row-major. These only get cleared, never freed, to keep their capacity between frames.
+		std::vector<std::vector<const InterRenderTriangle*>> tileBins;
+
+		//! Edge length (in pixels) of the square cells of the hierarchical z-buffer. Tiles are made of whole cells, and cells of whole blocks.
+		static constexpr std::size_t hiZCellSize = 8;
+		static constexpr std::size_t cellsPerTileRow = tileSize / hiZCellSize;
+
+		//! Number of hierarchical z-buffer cells per row and column
+		Vector2i numHiZCells;
+
+		//! Hierarchical z-buffer. Nearest and farthest depth stored in zBuffer, per cell, row-major.
+		//! Like the pixels themselves, a cell is only ever touched by the task drawing its tile.
+		std::vector<Real> hiZMin;
+		std::vector<Real> hiZMax;
+
+		//! Farthest depth stored in zBuffer, per tile. Triangles behind it get rejected with a single compare.
+		std::vector<Real> tileMaxDepth;
+
+		//! Value the z-buffer gets cleared to
+		static constexpr Real clearDepth = 1000000;
+
         const double globalIllumination;
 	};
 }
@@ -0,0 +1,13 @@
+#pragma once
+
+namespace TorGL
+{
+	//! Floating point type of Tornado's per-pixel data (z-buffer and the rasterization kernels).
+	//! Double by default. Define _TORNADO_SINGLE_PRECISION at build time to rasterize in float instead.
+	//! That halves the z-buffer's memory traffic and doubles the number of pixels per SIMD register.
+#ifdef _TORNADO_SINGLE_PRECISION
+	typedef float Real;
+#else
+	typedef double Real;
+#endif
+}
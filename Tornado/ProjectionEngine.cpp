@@ -1,5 +1,6 @@
 #include "ProjectionEngine.h"
 #include "ClippingEngine.h"
+#include <algorithm>
 
 using namespace TorGL;
 
@@ -14,6 +15,7 @@ void ProjectionEngine::BeginBatch(std::size_t reserve_triangles)
 {
 	registeredTriangles.clear();
 	projectedTriangles.clear();
+	registeredMeshes.clear();
 
 	registeredTriangles.reserve(reserve_triangles);
 	projectedTriangles.reserve(reserve_triangles);
@@ -33,23 +35,150 @@ void ProjectionEngine::HardsetRenderTriangles(std::vector<const RenderTriangle3D
 	return;
 }
 
+void ProjectionEngine::RegisterRenderMesh(const RenderMesh3D* mesh)
+{
+	registeredMeshes.emplace_back(mesh);
+	return;
+}
+
 void ProjectionEngine::Project(const ProjectionProperties& projectionProperties, const Matrix4x4& worldMatrix)
 {
-	for (const RenderTriangle3D* tri : registeredTriangles)
-	{
-		WorkerTask* newTask = new WorkerTask; // Will be freed by the workerPool
-		newTask->task = std::bind(&ProjectionEngine::Thread_ProjectTriangle, this,
-			tri, projectionProperties, worldMatrix);
+	// Project all shared mesh vertices once
+	ProjectMeshVertices(projectionProperties, worldMatrix);
+
+	// Source triangles are all RenderTriangle3D's, followed by all mesh triangles
+	meshTriangleOffsets.resize(registeredMeshes.size() + 1);
+	meshTriangleOffsets[0] = registeredTriangles.size();
+	for (std::size_t i = 0; i < registeredMeshes.size(); i++)
+		meshTriangleOffsets[i + 1] = meshTriangleOffsets[i] + registeredMeshes[i]->numTriangles;
+
+	const std::size_t numSourceTriangles = meshTriangleOffsets.back();
+
+	// Every chunk of source triangles writes to its own output buffer. No locking involved.
+	// Give every thread a few chunks, to allow for stealing.
+	const std::size_t grain = std::max<std::size_t>(1, numSourceTriangles / ((workerPool->GetNumWorkers() + 1) * 8));
+	const std::size_t numChunks = (numSourceTriangles + grain - 1) / grain;
+
+	// Only ever grow, so that the chunk buffers keep their capacity between frames
+	if (chunkResults.size() < numChunks)
+		chunkResults.resize(numChunks);
 
-		workerPool->QueueTask(newTask);
+	workerPool->ParallelFor(0, numSourceTriangles, grain,
+		[this, &projectionProperties, &worldMatrix, grain](std::size_t begin, std::size_t end)
+		{
+			std::vector<InterRenderTriangle>& results = chunkResults[begin / grain];
+			results.clear();
+
+			std::size_t i = begin;
+			for (; (i < end) && (i < registeredTriangles.size()); i++)
+				Thread_ProjectTriangle(registeredTriangles[i], projectionProperties, worldMatrix, results);
+
+			if (i == end)
+				return;
+
+			// Chunks are contiguous, so the mesh, and its submesh, only have to be looked up once
+			std::size_t meshIndex = FindMesh(meshTriangleOffsets, i);
+			std::size_t submeshIndex = FindSubmesh(*registeredMeshes[meshIndex], i - meshTriangleOffsets[meshIndex]);
+			for (; i < end; i++)
+			{
+				while (i >= meshTriangleOffsets[meshIndex + 1])
+				{
+					meshIndex++;
+					submeshIndex = 0;
+				}
+
+				const RenderMesh3D& mesh = *registeredMeshes[meshIndex];
+				const std::size_t triangleIndex = i - meshTriangleOffsets[meshIndex];
+
+				while ((submeshIndex < mesh.numSubmeshes) && (triangleIndex >= mesh.submeshes[submeshIndex].end))
+					submeshIndex++;
+
+				// Not covered by any submesh, or the submesh has no material of its own
+				const Material* material = mesh.material;
+				if ((submeshIndex < mesh.numSubmeshes) && (triangleIndex >= mesh.submeshes[submeshIndex].begin) && (mesh.submeshes[submeshIndex].material != nullptr))
+					material = mesh.submeshes[submeshIndex].material;
+
+				Thread_ProjectMeshTriangle(meshIndex, triangleIndex, material, projectionProperties, results);
+			}
+		}
+	);
+
+	// Concatenate the chunks in order. This keeps the output in source triangle order, no matter which thread did what.
+	chunkOffsets.resize(numChunks);
+	std::size_t numProjectedTriangles = 0;
+	for (std::size_t i = 0; i < numChunks; i++)
+	{
+		chunkOffsets[i] = numProjectedTriangles;
+		numProjectedTriangles += chunkResults[i].size();
 	}
 
-	workerPool->Execute();
+	projectedTriangles.resize(numProjectedTriangles);
+
+	workerPool->ParallelFor(0, numChunks, 1,
+		[this](std::size_t begin, std::size_t end)
+		{
+			for (std::size_t i = begin; i < end; i++)
+				std::copy(chunkResults[i].begin(), chunkResults[i].end(), projectedTriangles.begin() + chunkOffsets[i]);
+		}
+	);
 
 	return;
 }
 
-void ProjectionEngine::Thread_ProjectTriangle(const RenderTriangle3D* tri, const ProjectionProperties& projectionProperties, const Matrix4x4 worldMatrix)
+void ProjectionEngine::ProjectMeshVertices(const ProjectionProperties& projectionProperties, const Matrix4x4& worldMatrix)
+{
+	meshVertexOffsets.resize(registeredMeshes.size() + 1);
+	meshVertexOffsets[0] = 0;
+	for (std::size_t i = 0; i < registeredMeshes.size(); i++)
+		meshVertexOffsets[i + 1] = meshVertexOffsets[i] + registeredMeshes[i]->numPositions;
+
+	projectedVertices.resize(meshVertexOffsets.back());
+
+	workerPool->ParallelFor(0, projectedVertices.size(), 0,
+		[this, &projectionProperties, &worldMatrix](std::size_t begin, std::size_t end)
+		{
+			std::size_t meshIndex = FindMesh(meshVertexOffsets, begin);
+			for (std::size_t i = begin; i < end; i++)
+			{
+				while (i >= meshVertexOffsets[meshIndex + 1])
+					meshIndex++;
+
+				const Vector3d& pos_ws = registeredMeshes[meshIndex]->positions[i - meshVertexOffsets[meshIndex]];
+				ProjectedVertex& pv = projectedVertices[i];
+
+				// Same math as for RenderTriangle3D's, just once per vertex
+				pv.pos_wsmx = pos_ws * worldMatrix;
+				pv.pos_cs = Vector4d(pv.pos_wsmx.x, pv.pos_wsmx.y, pv.pos_wsmx.z, 1.0) * projectionProperties.GetProjectionMatrix();
+			}
+		}
+	);
+
+	return;
+}
+
+std::size_t ProjectionEngine::FindMesh(const std::vector<std::size_t>& offsets, std::size_t index)
+{
+	// First offset greater than index belongs to the mesh after the one we're looking for. Empty meshes get skipped this way.
+	return (std::size_t)(std::upper_bound(offsets.begin(), offsets.end(), index) - offsets.begin()) - 1;
+}
+
+std::size_t ProjectionEngine::FindSubmesh(const RenderMesh3D& mesh, std::size_t triangleIndex)
+{
+	if (mesh.submeshes == nullptr)
+		return 0;
+
+	const RenderSubmesh* const submeshesEnd = mesh.submeshes + mesh.numSubmeshes;
+	const RenderSubmesh* const found = std::partition_point(mesh.submeshes, submeshesEnd,
+		[triangleIndex](const RenderSubmesh& submesh)
+		{
+			return submesh.end <= triangleIndex;
+		}
+	);
+
+	return (std::size_t)(found - mesh.submeshes);
+}
+
+void ProjectionEngine::Thread_ProjectTriangle(const RenderTriangle3D* tri, const ProjectionProperties& projectionProperties, const Matrix4x4& worldMatrix, std::vector<InterRenderTriangle>& results)
 {
 	// Create InterRenderTriangle
 	InterRenderTriangle ird;
@@ -79,11 +208,67 @@ void ProjectionEngine::Thread_ProjectTriangle(const RenderTriangle3D* tri, const
 	ird.b.pos_cs = Vector4d(ird.b.pos_wsmx.x, ird.b.pos_wsmx.y, ird.b.pos_wsmx.z, 1.0) * projectionProperties.GetProjectionMatrix();
 	ird.c.pos_cs = Vector4d(ird.c.pos_wsmx.x, ird.c.pos_wsmx.y, ird.c.pos_wsmx.z, 1.0) * projectionProperties.GetProjectionMatrix();
 
+	// Drop triangles facing away from the camera, before spending any time on clipping them
+	if (cullBackfaces && !BackfaceCullingEngine::IsFrontFacing(ird.a.pos_cs, ird.b.pos_cs, ird.c.pos_cs))
+		return;
+
+	Thread_ClipTriangle(ird, projectionProperties, results);
+
+	return;
+}
+
+void ProjectionEngine::Thread_ProjectMeshTriangle(std::size_t meshIndex, std::size_t triangleIndex, const Material* material, const ProjectionProperties& projectionProperties, std::vector<InterRenderTriangle>& results)
+{
+	const RenderMesh3D& mesh = *registeredMeshes[meshIndex];
+	const RenderVertexIndices* idx = &mesh.indices[triangleIndex * 3];
+	const ProjectedVertex* vertices = &projectedVertices[meshVertexOffsets[meshIndex]];
+
+	const ProjectedVertex& a = vertices[idx[0].v];
+	const ProjectedVertex& b = vertices[idx[1].v];
+	const ProjectedVertex& c = vertices[idx[2].v];
+
+	// Drop triangles facing away from the camera, before even assembling them
+	if (cullBackfaces && !BackfaceCullingEngine::IsFrontFacing(a.pos_cs, b.pos_cs, c.pos_cs))
+		return;
+
+	// Create InterRenderTriangle
+	InterRenderTriangle ird;
+
+	ird.material = material;
+
+	ird.a.pos_ws = mesh.positions[idx[0].v];
+	ird.b.pos_ws = mesh.positions[idx[1].v];
+	ird.c.pos_ws = mesh.positions[idx[2].v];
+
+	ird.a.pos_uv = mesh.uvs[idx[0].uv];
+	ird.b.pos_uv = mesh.uvs[idx[1].uv];
+	ird.c.pos_uv = mesh.uvs[idx[2].uv];
+
+	ird.a.normal = mesh.normals[idx[0].vn];
+	ird.b.normal = mesh.normals[idx[1].vn];
+	ird.c.normal = mesh.normals[idx[2].vn];
+
+	ird.a.pos_wsmx = a.pos_wsmx;
+	ird.b.pos_wsmx = b.pos_wsmx;
+	ird.c.pos_wsmx = c.pos_wsmx;
+
+	ird.a.pos_cs = a.pos_cs;
+	ird.b.pos_cs = b.pos_cs;
+	ird.c.pos_cs = c.pos_cs;
+
+	Thread_ClipTriangle(ird, projectionProperties, results);
+
+	return;
+}
+
+void ProjectionEngine::Thread_ClipTriangle(const InterRenderTriangle& ird, const ProjectionProperties& projectionProperties, std::vector<InterRenderTriangle>& results)
+{
 	// Clip triangle
-	std::vector<InterRenderTriangle> clippingResults = ClippingEngine::Clip(ird);
+	ClippingResult clippingResults;
+	ClippingEngine::Clip(ird, clippingResults, projectionProperties.GetGuardBand());
 
 	// Have we got any results? If not, abort, since the triangle has been dropped.
-	if (clippingResults.size() == 0)
+	if (clippingResults.Empty())
 		return;
 
 	// Now continue treating all of our fragments
@@ -116,15 +301,24 @@ void ProjectionEngine::Thread_ProjectTriangle(const RenderTriangle3D* tri, const
 		cird.ss_iarea = 1.0 / cird.ss_area;
 	}
 
-	// Now that we have transformed all of our triangles into device space, let's now add our results to the results vector
-	std::lock_guard<std::mutex> guard(resultVecMutex);
-
+	// Now that we have transformed all of our triangles into device space, let's now add our results to the chunks results
 	for (InterRenderTriangle& cird : clippingResults)
-		projectedTriangles.emplace_back(cird);
+		results.emplace_back(cird);
+
+	return;
+}
 
+void ProjectionEngine::SetCullBackfaces(bool cullBackfaces)
+{
+	this->cullBackfaces = cullBackfaces;
 	return;
 }
 
+bool ProjectionEngine::GetCullBackfaces() const
+{
+	return cullBackfaces;
+}
+
 std::vector<InterRenderTriangle>& ProjectionEngine::Finish()
 {
 	return projectedTriangles;
@@ -2,15 +2,18 @@
 #include "Matrix4x4.h"
 #include "WorkerPool.h"
 #include "RenderTriangle3D.h"
+#include "RenderMesh3D.h"
 #include "InterRenderTriangle.h"
 #include "ProjectionProperties.h"
+#include "BackfaceCullingEngine.h"
 #include <vector>
-#include <mutex>
 
 namespace TorGL
 {
 	/** The engine performing the actual perspective projection.
 	* And that it does in a multithreaded fashion.
+	*
+	* Vertices of registered RenderMesh3D's get projected once, into a per-frame vertex cache. Their triangles are then assembled from that cache.
 	*/
 	class ProjectionEngine
 	{
@@ -27,20 +30,66 @@ namespace TorGL
 		//! Faster way of registering a lot of RenderTriangle3D's at once by using std::move. This will consume the original vector.
 		void HardsetRenderTriangles(std::vector<const RenderTriangle3D*>&& triangles);
 
+		//! Will register an indexed RenderMesh3D to be projected. Its triangles come after all RenderTriangle3D's.
+		void RegisterRenderMesh(const RenderMesh3D* mesh);
+
 		//! Will chew through projecting (and clipping) all the registered triangles using multiple threads.
 		void Project(const ProjectionProperties& projectionProperties, const Matrix4x4& worldMatrix);
 
+		//! Will set whether triangles facing away from the camera get dropped right after projecting them into clipping space,
+		//! before clipping them. Enabled by default.
+		void SetCullBackfaces(bool cullBackfaces);
+
+		//! Will return whether triangles facing away from the camera get dropped while projecting
+		bool GetCullBackfaces() const;
+
 		//! Will clean up any remaining mess and return the projected triangles as InterRenderTriangles.
 		//! At this point, pos_ss will have been set.
 		std::vector<InterRenderTriangle>& Finish();
 
 	private:
-		//! This is the task given to the WorkerPool. One task (call) per registered triangle.
-		void Thread_ProjectTriangle(const RenderTriangle3D* tri, const ProjectionProperties& projectionProperties, const Matrix4x4 worldMatrix);
+		//! A vertex of a RenderMesh3D, after projection
+		struct ProjectedVertex
+		{
+			Vector3d pos_wsmx;
+			Vector4d pos_cs;
+		};
+
+		//! Will project all vertices of all registered meshes into projectedVertices
+		void ProjectMeshVertices(const ProjectionProperties& projectionProperties, const Matrix4x4& worldMatrix);
+
+		//! Will return the index of the registered mesh containing the element at index, given a prefix sum of the meshes element counts
+		static std::size_t FindMesh(const std::vector<std::size_t>& offsets, std::size_t index);
+
+		//! Will return the index of the first submesh of mesh not ending before triangleIndex. numSubmeshes, if there is none.
+		static std::size_t FindSubmesh(const RenderMesh3D& mesh, std::size_t triangleIndex);
+
+		//! Will project a single triangle, and append the clipped results to results. Called by the WorkerPool for every registered triangle, in chunks.
+		void Thread_ProjectTriangle(const RenderTriangle3D* tri, const ProjectionProperties& projectionProperties, const Matrix4x4& worldMatrix, std::vector<InterRenderTriangle>& results);
+
+		//! Will assemble a single triangle of a registered mesh from the vertex cache, and append the clipped results to results.
+		void Thread_ProjectMeshTriangle(std::size_t meshIndex, std::size_t triangleIndex, const Material* material, const ProjectionProperties& projectionProperties, std::vector<InterRenderTriangle>& results);
+
+		//! Will clip a triangle in clipping space, and map the results to screen space
+		void Thread_ClipTriangle(const InterRenderTriangle& ird, const ProjectionProperties& projectionProperties, std::vector<InterRenderTriangle>& results);
 
 		WorkerPool* workerPool;
+		bool cullBackfaces = true;
 		std::vector<const RenderTriangle3D*> registeredTriangles;
 		std::vector<InterRenderTriangle> projectedTriangles;
-		std::mutex resultVecMutex;
+
+		std::vector<const RenderMesh3D*> registeredMeshes;
+
+		//! Prefix sums of the registered meshes vertex and triangle counts. Mesh i owns [offsets[i], offsets[i + 1]).
+		//! Triangle offsets start after the registered RenderTriangle3D's.
+		std::vector<std::size_t> meshVertexOffsets;
+		std::vector<std::size_t> meshTriangleOffsets;
+
+		//! All vertices of all registered meshes, projected. Kept between frames.
+		std::vector<ProjectedVertex> projectedVertices;
+
+		//! One output buffer per chunk of registered triangles, and where it starts in projectedTriangles. Kept between frames.
+		std::vector<std::vector<InterRenderTriangle>> chunkResults;
+		std::vector<std::size_t> chunkOffsets;
 	};
 }
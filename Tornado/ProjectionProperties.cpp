@@ -1,7 +1,9 @@
 #include "ProjectionProperties.h"
+#include "../Eule/Math.h"
 #include <math.h>
 
 using namespace TorGL;
+using namespace Eule;
 
 ProjectionProperties::ProjectionProperties(const Vector2i& resolution, double fov, double nearclip, double farclip)
 	:
@@ -89,6 +91,17 @@ void ProjectionProperties::SetResolution(const Vector2i& resolution)
 	return;
 }
 
+double ProjectionProperties::GetGuardBand() const
+{
+	return guardBand;
+}
+
+void ProjectionProperties::SetGuardBand(double guardBand)
+{
+	this->guardBand = Math::Clamp(guardBand, 1.0, maxGuardBand);
+	return;
+}
+
 const Matrix4x4& ProjectionProperties::GetProjectionMatrix() const
 {
 	return projectionMatrix;
@@ -43,6 +43,15 @@ namespace TorGL
 		//! This will set the rendering resolution
 		void SetResolution(const Vector2i& resolution);
 
+		//! Will return the current guard band, as a multiple of the screen size
+		double GetGuardBand() const;
+		//! Will set the guard band, as a multiple of the screen size. Triangles crossing the screen edges only get clipped
+		//! when they reach out further than this. 1 clips exactly at the screen edges. Gets clamped to [1, maxGuardBand].
+		void SetGuardBand(double guardBand);
+
+		//! Largest allowed guard band. Keeps the rasterizers fixed-point edge functions from overflowing.
+		static constexpr double maxGuardBand = 64.0;
+
 		//! Returns the current projection matrix.
 		//! This value is cached and cheap to call.
 		const Matrix4x4& GetProjectionMatrix() const;
@@ -55,6 +64,7 @@ namespace TorGL
 		double nearclip;
 		double farclip;
 		long double sqrFarclip;
+		double guardBand = 8.0;
 		double aspectRatio;
 		Vector2i resolution;
 		Vector2d halfResolution;
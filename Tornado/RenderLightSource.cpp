@@ -1,5 +1,6 @@
 #include "RenderLightSource.h"
 #include "../Eule/Math.h"
+#include <limits>
 
 using namespace TorGL;
 using namespace Eule;
@@ -49,6 +50,11 @@ double RenderLightSource::GetSoftness() const
 	return softness;
 }
 
+double RenderLightSource::GetRange() const
+{
+	return std::numeric_limits<double>::infinity();
+}
+
 Vector3d& RenderLightSource::GetPosition()
 {
 	return position;
@@ -39,6 +39,10 @@ namespace TorGL
 		//! Will return this lightsources softness
 		double GetSoftness() const;
 
+		//! Will return the distance beyond which this lightsource does not light anything anymore.
+		//! Infinity, if there is no such distance.
+		virtual double GetRange() const;
+
 		//! Will set this lightsources 3d position
 		void SetPosition(const Vector3d& position);
 
@@ -0,0 +1,65 @@
+#pragma once
+#include "Vector2.h"
+#include "Vector3.h"
+#include "Material.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace TorGL
+{
+	//! This struct holds indices for all important vertex types of a single triangle corner.
+	//! 32 bit each, which halves the memory (and bandwidth) of index buffers, compared to std::size_t.
+	struct RenderVertexIndices
+	{
+		//! Index of the 3D world vertex
+		std::uint32_t v;
+
+		// Index of the uv (texture space) vertex
+		std::uint32_t uv;
+
+		// Index of the normal value
+		std::uint32_t vn;
+	};
+
+	//! A contiguous range of triangles of a RenderMesh3D, sharing a material
+	struct RenderSubmesh
+	{
+		//! First triangle of the range
+		std::size_t begin;
+
+		//! One past the last triangle of the range
+		std::size_t end;
+
+		//! Material of all triangles in the range. nullptr to use the meshes material.
+		const Material* material;
+	};
+
+	/** Indexed representation of a mesh to be rendered.
+	* Triangles reference shared vertices by index, so every vertex only gets projected once per frame, no matter how many triangles use it.
+	* This struct does not own any of its arrays. They have to stay alive until the frame has been rendered.
+	*/
+	struct RenderMesh3D
+	{
+		//! Vertex positions in world space
+		const Vector3d* positions = nullptr;
+		std::size_t numPositions = 0;
+
+		//! Vertex positions in texture space
+		const Vector2d* uvs = nullptr;
+
+		//! Vertex normals
+		const Vector3d* normals = nullptr;
+
+		//! Three corners per triangle, indexing into positions, uvs and normals
+		const RenderVertexIndices* indices = nullptr;
+		std::size_t numTriangles = 0;
+
+		//! Material to render all triangles with
+		const Material* material = nullptr;
+
+		//! Optional. Ascending, non-overlapping ranges of triangles with their own material, overriding material.
+		//! Triangles not covered by any range use material. nullptr, if all triangles use material.
+		const RenderSubmesh* submeshes = nullptr;
+		std::size_t numSubmeshes = 0;
+	};
+}
@@ -55,6 +55,12 @@ Color RenderPointLight::GetColorIntensityFactors(const InterRenderTriangle* ird,
 	);
 }
 
+double RenderPointLight::GetRange() const
+{
+	// Same cutoff as in GetColorIntensityFactors()
+	return intensityTimes255;
+}
+
 double RenderPointLight::GetHardlightFac(const double dot, const double invSqrCoefficient) const
 {
 	if (dot < 0)
@@ -14,6 +14,9 @@ namespace TorGL
 		//! Multiply the raw color values with these factors to get the shaded color (for this light)
 		Color GetColorIntensityFactors(const InterRenderTriangle* ird, const Vector3d& point, const Vector3d& normal) const override;
 
+		//! Will return the distance beyond which GetColorIntensityFactors() always returns black
+		double GetRange() const override;
+
 	private:
 		double GetHardlightFac(const double dot, const double invSqrCoefficient) const;
 		double GetSoftlightFac(const double invSqrCoefficient) const;
@@ -0,0 +1,15 @@
+#pragma once
+// Compiler-specific helpers for vectorized code paths.
+// Tornado does not use intrinsics. Hot kernels are written as fixed-width lane loops that the compiler vectorizes.
+// On supported compilers, TORGL_SIMD_CLONES additionally emits an AVX2 version of a function next to the generic
+// one, and picks one of them at load time by querying CPUID. Other compilers just get the generic (scalar/SSE2) version.
+
+#if defined(__x86_64__) && defined(__linux__) && defined(__has_attribute)
+#if __has_attribute(target_clones)
+#define TORGL_SIMD_CLONES __attribute__((target_clones("avx2", "default")))
+#endif
+#endif
+
+#ifndef TORGL_SIMD_CLONES
+#define TORGL_SIMD_CLONES
+#endif
@@ -17,8 +17,25 @@ namespace {
 #endif
 
 Tornado::Tornado(const Vector2i& renderTargetSize, std::size_t numRenderthreads, double globalIllumination)
+	:
+	workerPool { new WorkerPool(numRenderthreads) },
+	ownsWorkerPool { true }
+{
+	Init(renderTargetSize, globalIllumination);
+	return;
+}
+
+Tornado::Tornado(const Vector2i& renderTargetSize, WorkerPool* workerPool, double globalIllumination)
+	:
+	workerPool { workerPool },
+	ownsWorkerPool { false }
+{
+	Init(renderTargetSize, globalIllumination);
+	return;
+}
+
+void Tornado::Init(const Vector2i& renderTargetSize, double globalIllumination)
 {
-	workerPool = new WorkerPool(numRenderthreads);
 	backfaceCullingEngine = new BackfaceCullingEngine(workerPool);
 	projectionEngine = new ProjectionEngine(workerPool);
 	pixelBuffer = new PixelBuffer<3>(renderTargetSize);
@@ -29,7 +46,10 @@ Tornado::Tornado(const Vector2i& renderTargetSize, std::size_t numRenderthreads,
 
 Tornado::~Tornado()
 {
-	delete workerPool;
+	// Shared pools belong to someone else
+	if (ownsWorkerPool)
+		delete workerPool;
+
 	delete backfaceCullingEngine;
 	delete projectionEngine;
 	delete drawingEngine;
@@ -47,6 +67,7 @@ Tornado::~Tornado()
 void Tornado::BeginFrame()
 {
 	registeredTriangles.clear();
+	registeredMeshes.clear();
 	registeredLightsources.clear();
 
 	registeredTriangles.reserve(200);
@@ -62,6 +83,13 @@ void Tornado::RegisterRender(const RenderTriangle3D* tri)
 	return;
 }
 
+void Tornado::RegisterRender(const RenderMesh3D* mesh)
+{
+	registeredMeshes.emplace_back(mesh);
+
+	return;
+}
+
 void Tornado::RegisterRender(const RenderLightSource* lightSource)
 {
 	registeredLightsources.emplace_back(lightSource);
@@ -82,6 +110,9 @@ void Tornado::Render(const ProjectionProperties& projectionProperties, const Mat
 	// Pass triangle vector
 	projectionEngine->HardsetRenderTriangles(std::move(registeredTriangles));
 
+	for (const RenderMesh3D* mesh : registeredMeshes)
+		projectionEngine->RegisterRenderMesh(mesh);
+
 	// Project and receive results
 	projectionEngine->Project(projectionProperties, worldMatrix);
 	std::vector<InterRenderTriangle>& projectedTriangles = projectionEngine->Finish();
@@ -96,13 +127,25 @@ void Tornado::Render(const ProjectionProperties& projectionProperties, const Mat
         clock_reset();
     #endif
 
-	backfaceCullingEngine->BeginBatch(registeredTriangles.size());
+	drawingEngine->BeginBatch(projectedTriangles.size());
+
+	// If the projection engine has already dropped the backfaces, the culling engine is skipped entirely
+	if (projectionEngine->GetCullBackfaces())
+	{
+		for (const InterRenderTriangle& ird : projectedTriangles)
+			drawingEngine->RegisterInterRenderTriangle(&ird);
+	}
+	else
+	{
+		backfaceCullingEngine->BeginBatch(projectedTriangles.size());
 
-	for (const InterRenderTriangle& ird : projectedTriangles)
-		backfaceCullingEngine->RegisterInterRenderTriangle(&ird);
+		for (const InterRenderTriangle& ird : projectedTriangles)
+			backfaceCullingEngine->RegisterInterRenderTriangle(&ird);
 
-	backfaceCullingEngine->Cull();
-	std::vector<const InterRenderTriangle*>& culledTriangles = backfaceCullingEngine->Finish();
+		backfaceCullingEngine->Cull();
+
+		drawingEngine->HardsetInterRenderTriangles(std::move(backfaceCullingEngine->Finish()));
+	}
 
     #ifdef _BENCHMARK_CONTEXT
         _benchmark_cullBackfacesTime = clock_getElapsedTimeMs();
@@ -120,8 +163,6 @@ void Tornado::Render(const ProjectionProperties& projectionProperties, const Mat
     #ifdef _BENCHMARK_CONTEXT
         clock_reset();
     #endif
-	drawingEngine->BeginBatch(projectedTriangles.size());
-	drawingEngine->HardsetInterRenderTriangles(std::move(culledTriangles));
 	drawingEngine->Draw();
     #ifdef _BENCHMARK_CONTEXT
         _benchmark_drawTrianglesTime = clock_getElapsedTimeMs();
@@ -134,3 +175,25 @@ const PixelBuffer<3>* Tornado::GetPixelBuffer() const
 {
 	return pixelBuffer;
 }
+
+void Tornado::SetDrawMode(DRAW_MODE mode)
+{
+	drawingEngine->SetDrawMode(mode);
+	return;
+}
+
+DRAW_MODE Tornado::GetDrawMode() const
+{
+	return drawingEngine->GetDrawMode();
+}
+
+void Tornado::SetEarlyBackfaceCulling(bool earlyBackfaceCulling)
+{
+	projectionEngine->SetCullBackfaces(earlyBackfaceCulling);
+	return;
+}
+
+bool Tornado::GetEarlyBackfaceCulling() const
+{
+	return projectionEngine->GetCullBackfaces();
+}
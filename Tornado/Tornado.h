@@ -14,6 +14,10 @@ namespace TorGL
 	{
 	public:
 		Tornado(const Vector2i& renderTargetSize, std::size_t numRenderthreads, double globalIllumination = 0);
+
+		//! Will render using an externally owned WorkerPool, instead of creating its own. It has to outlive this Tornado.
+		//! Lets multiple renderers share a single pool (see WorkerPool::GetShared()).
+		Tornado(const Vector2i& renderTargetSize, WorkerPool* workerPool, double globalIllumination = 0);
 		~Tornado();
 
 		//! Will initialize the rendering of a new frame.
@@ -22,6 +26,9 @@ namespace TorGL
 		//! Will register a RenderTriangle3D to be rendered.
 		void RegisterRender(const RenderTriangle3D* tri);
 
+		//! Will register an indexed RenderMesh3D to be rendered. Its vertices only get projected once, no matter how many triangles share them.
+		void RegisterRender(const RenderMesh3D* mesh);
+
 		//! Will register a RenderLightSource to be rendered
 		void RegisterRender(const RenderLightSource* lightSource);
 
@@ -31,14 +38,32 @@ namespace TorGL
 		//! Will return the pixel buffer with the rendered pixel data.
 		const PixelBuffer<3>* GetPixelBuffer() const;
 
+		//! Will set how triangles get drawn. Can be changed between frames.
+		void SetDrawMode(DRAW_MODE mode);
+
+		//! Will return how triangles get drawn
+		DRAW_MODE GetDrawMode() const;
+
+		//! Will set whether backfaces get culled early, in clipping space, while projecting. This is the default.
+		//! If disabled, they get culled in a separate pass after projection instead.
+		void SetEarlyBackfaceCulling(bool earlyBackfaceCulling);
+
+		//! Will return whether backfaces get culled early, while projecting
+		bool GetEarlyBackfaceCulling() const;
+
 	private:
+		//! Creates the engines. Shared by both constructors.
+		void Init(const Vector2i& renderTargetSize, double globalIllumination);
+
 		WorkerPool* workerPool;
+		bool ownsWorkerPool;
 		BackfaceCullingEngine* backfaceCullingEngine;
 		ProjectionEngine* projectionEngine;
 		DrawingEngine* drawingEngine;
 		PixelBuffer<3>* pixelBuffer;
 
 		std::vector<const RenderTriangle3D*> registeredTriangles;
+		std::vector<const RenderMesh3D*> registeredMeshes;
 		std::vector<const RenderLightSource*> registeredLightsources;
 
         // Benchmarking stuff
@@ -1,5 +1,4 @@
 #include "WorkerPool.h"
-#include "CrossPlatformSyscalls.h"
 
 using namespace TorGL;
 
@@ -19,7 +18,7 @@ WorkerPool::WorkerPool(std::size_t numWorkers)
 
 	for (std::size_t i = 0; i < numWorkers; i++)
 	{
-		Worker* newWorker = new Worker(this);
+		Worker* newWorker = new Worker(this, i);
 		newWorker->ownThread = new std::thread(&Worker::Lifecycle, newWorker);
 
 		workers.push_back(newWorker);
@@ -37,7 +36,7 @@ WorkerPool::~WorkerPool()
 	// Wake up the workers for them to notice the stop signal
 	{
 		std::unique_lock<std::mutex> lck(mutex);
-		conditional_lock.notify_all();
+		workAvailable.notify_all();
 	}
 
 	// Wait for all workers to finish
@@ -48,7 +47,7 @@ WorkerPool::~WorkerPool()
 	for (Worker* w : workers)
 		delete w;
 	workers.clear();
-	
+
 	// Free all tasks
 	for (WorkerTask* wt : taskQueue)
 		delete wt;
@@ -57,6 +56,13 @@ WorkerPool::~WorkerPool()
 	return;
 }
 
+WorkerPool& WorkerPool::GetShared()
+{
+	// Thread-safe initialization is guaranteed for function-local statics
+	static WorkerPool sharedPool(0);
+	return sharedPool;
+}
+
 void WorkerPool::QueueTask(WorkerTask* task)
 {
 	taskQueue.push_back(task);
@@ -93,36 +99,10 @@ std::size_t WorkerPool::GetNumActiveWorkers() const
 
 void WorkerPool::Execute()
 {
-	// As long as we still have unassigned tasks to do
-	while (GetQueueLength() > 0)
-	{
-		bool didQueueAnything = false;
-
-		for (Worker* w : workers)
-			if (w->IsIdling()) // And if a worker is not working
-				for (WorkerTask* wt : taskQueue)
-					if (wt->state == WorkerTask::State::QUEUED) // And if a task is unassigned
-					{
-						w->DoTask(wt);	// Add that task
-						didQueueAnything = true;
-						
-					}
-
-		// If we queued a new task, we should notify the threads about it
-		if (didQueueAnything)
-		{
-			std::unique_lock<std::mutex> lck(mutex);
-			conditional_lock.notify_all();
-		}
+	std::unique_lock<std::mutex> lck(dispatchMutex);
+
+	Dispatch(taskQueue.size());
 
-		//cpSleep(0); // Reduce cpu overhead
-	}
-	
-	// Now all tasks are assigned. Wait for them to finish
-	for (const Worker* w : workers)
-		while (!w->IsIdling())
-			cpSleep(0);
-	
 	// Now all tasks are finished. Let's clean up after ourselves!
 	for (WorkerTask* wt : taskQueue)
 		delete wt;
@@ -131,11 +111,104 @@ void WorkerPool::Execute()
 	return;
 }
 
+void WorkerPool::Dispatch(std::size_t numJobs)
+{
+	if (numJobs == 0)
+		return;
+
+	// Has to be set before any job can be taken
+	numPendingJobs.store(numJobs, std::memory_order_relaxed);
+
+	// Hand every worker a contiguous range of jobs. Neighbouring jobs tend to work on neighbouring data.
+	for (std::size_t i = 0; i < workers.size(); i++)
+	{
+		const uint64_t begin = (uint64_t)(numJobs * i / workers.size());
+		const uint64_t end = (uint64_t)(numJobs * (i + 1) / workers.size());
+		workers[i]->deque.store((begin << 32) | end, std::memory_order_release);
+	}
+
+	// Wake up the workers
+	{
+		std::unique_lock<std::mutex> lck(mutex);
+		generation.fetch_add(1, std::memory_order_release);
+	}
+	workAvailable.notify_all();
+
+	// Help out, instead of just waiting
+	RunJobs(nullptr);
+
+	// Now all jobs are taken. Wait for them to finish. They are likely almost done, so spin for a bit before going to sleep.
+	for (std::size_t i = 0; (i < numSpins) && (numPendingJobs.load(std::memory_order_acquire) > 0); i++)
+		std::this_thread::yield();
+
+	if (numPendingJobs.load(std::memory_order_acquire) > 0)
+	{
+		std::unique_lock<std::mutex> lck(mutex);
+		jobsFinished.wait(lck, [this] { return numPendingJobs.load(std::memory_order_acquire) == 0; });
+	}
+
+	return;
+}
+
+void WorkerPool::RunJobs(Worker* self)
+{
+	uint32_t jobIndex;
+
+	// Work through our own deque first
+	if (self != nullptr)
+		while (self->PopFront(jobIndex))
+			RunJob(jobIndex);
+
+	// Then steal from everyone else, starting with our neighbour.
+	// Deques only ever shrink during Dispatch(), so a single pass is enough to leave all of them empty.
+	const std::size_t firstVictim = (self != nullptr) ? self->index + 1 : 0;
+	for (std::size_t i = 0; i < workers.size(); i++)
+	{
+		Worker* victim = workers[(firstVictim + i) % workers.size()];
+
+		while (victim->StealBack(jobIndex))
+			RunJob(jobIndex);
+	}
+
+	return;
+}
+
+void WorkerPool::RunJob(uint32_t jobIndex)
+{
+	// Is it a chunk of a ParallelFor() range?
+	if (rangeTrampoline != nullptr)
+	{
+		const std::size_t begin = rangeBegin + (std::size_t)jobIndex * rangeGrain;
+		const std::size_t end = std::min(begin + rangeGrain, rangeEnd);
+		rangeTrampoline(rangeFunction, begin, end);
+	}
+	// Or a queued task?
+	else
+	{
+		WorkerTask* task = taskQueue[jobIndex];
+
+		task->state = WorkerTask::State::COMPUTING;
+		task->task();
+		task->state = WorkerTask::State::FINISHED;
+	}
+
+	// Was this the last one? Then wake up Dispatch(), if it went to sleep already.
+	// Notifying under the mutex makes sure it can't miss this between checking the counter and going to sleep.
+	if (numPendingJobs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+	{
+		std::unique_lock<std::mutex> lck(mutex);
+		jobsFinished.notify_all();
+	}
+
+	return;
+}
+
 ////////////////////////////////////////////////////////
 
-Worker::Worker(WorkerPool* pool)
+Worker::Worker(WorkerPool* pool, std::size_t index)
 	:
-	pool {pool}
+	pool {pool},
+	index {index}
 {
 	return;
 }
@@ -147,63 +220,93 @@ Worker::~Worker()
 	return;
 }
 
-bool Worker::DoTask(WorkerTask* task)
+bool Worker::IsIdling() const
 {
-	// Fail, if already working
-	if (!isIdling)
-		return false;
-
-	this->task = task;
-	this->task->state = WorkerTask::State::ASSIGNED;
-	isIdling = false;
-	doTask = true;
+	return isIdling.load(std::memory_order_relaxed);
+}
 
-	return true;
+void Worker::Stop()
+{
+	doStop.store(true, std::memory_order_release);
+	return;
 }
 
-bool Worker::IsIdling() const
+bool Worker::PopFront(uint32_t& jobIndex)
 {
-	return isIdling;
+	uint64_t current = deque.load(std::memory_order_acquire);
+
+	while (true)
+	{
+		const uint32_t begin = (uint32_t)(current >> 32);
+		const uint32_t end = (uint32_t)current;
+
+		if (begin >= end)
+			return false;
+
+		// On failure, current gets updated to the new value, and we try again
+		if (deque.compare_exchange_weak(current, ((uint64_t)(begin + 1) << 32) | end, std::memory_order_acq_rel, std::memory_order_acquire))
+		{
+			jobIndex = begin;
+			return true;
+		}
+	}
 }
 
-void Worker::Stop()
+bool Worker::StealBack(uint32_t& jobIndex)
 {
-	doStop = true;
-	return;
+	uint64_t current = deque.load(std::memory_order_acquire);
+
+	while (true)
+	{
+		const uint32_t begin = (uint32_t)(current >> 32);
+		const uint32_t end = (uint32_t)current;
+
+		if (begin >= end)
+			return false;
+
+		// On failure, current gets updated to the new value, and we try again
+		if (deque.compare_exchange_weak(current, ((uint64_t)begin << 32) | (end - 1), std::memory_order_acq_rel, std::memory_order_acquire))
+		{
+			jobIndex = end - 1;
+			return true;
+		}
+	}
 }
 
 void Worker::Lifecycle()
 {
-	while (!doStop)
+	uint64_t seenGeneration = 0;
+
+	while (true)
 	{
-		// Idle whilst waiting for either a stop, or a go signal
-		while ((!doTask) && (!doStop))
+		// Wait for either a stop, or new jobs.
+		// Frames dispatch jobs several times in a row, so poll for a bit before going to sleep.
+		for (std::size_t i = 0; i < WorkerPool::numSpins; i++)
+		{
+			if ((pool->generation.load(std::memory_order_acquire) != seenGeneration) || doStop.load(std::memory_order_acquire))
+				break;
+
+			std::this_thread::yield();
+		}
+
 		{
 			std::unique_lock<std::mutex> lck(pool->mutex);
-			pool->conditional_lock.wait(lck, [this] { return (doTask || doStop); });
-			//cpSleep(0);
+			pool->workAvailable.wait(lck, [this, seenGeneration] {
+				return (pool->generation.load(std::memory_order_acquire) != seenGeneration) || doStop.load(std::memory_order_acquire);
+			});
 		}
-		
+
 		// Something happened!
 		// Was it a stop signal?
-		if (doStop)
+		if (doStop.load(std::memory_order_acquire))
 			break;
 
 		// Or should we continue?
-		if (task != nullptr)
-		{
-			// Set flags for working
-			doTask = false;
-			isIdling = false;
-			task->state = WorkerTask::State::COMPUTING;
+		seenGeneration = pool->generation.load(std::memory_order_acquire);
 
-			// Run task
-			task->task();
-
-			// Set flags for idling
-			isIdling = true;
-			task->state = WorkerTask::State::FINISHED;
-		}
+		isIdling.store(false, std::memory_order_relaxed);
+		pool->RunJobs(this);
+		isIdling.store(true, std::memory_order_relaxed);
 	}
 
 	return;
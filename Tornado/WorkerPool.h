@@ -1,10 +1,13 @@
 #pragma once
 #include <functional>
 #include <cstddef>
+#include <cstdint>
 #include <vector>
 #include <thread>
 #include <mutex>
+#include <atomic>
 #include <condition_variable>
+#include <algorithm>
 
 namespace TorGL
 {
@@ -37,38 +40,33 @@ namespace TorGL
 	public:
 		~Worker();
 
-		//! Will attempt to start working on a provided WorkerTask. 
-		//! Will fail if the worker is already working on a different WorkerTask.  
-		//! This does not wake the worker up! `notify_all()` still needs to be called before it actually starts working!
-		bool DoTask(WorkerTask* task);
-
 		//! Will return whether or not the worker is currently working
 		bool IsIdling() const;
 
 		//! Will instruct the Worker to exit his THREAD!! (not the task) as soon as its current WorkerTask finishes
 		void Stop();
 
-		// These are needed for unit testing (without a worker pool)
-		#ifdef _DEBUG
-		Worker(WorkerPool* pool);
-		void SetThread(std::thread* thr) { ownThread = thr; };
-		std::thread* GetThread() { return ownThread; };
-		void Lifecycle();
-		#endif
-
 	private:
-		#ifndef _DEBUG
 		// Disallow public instanciation
-		Worker(WorkerPool* pool);
+		Worker(WorkerPool* pool, std::size_t index);
 		void Lifecycle();
-		#endif
+
+		//! Will take the next job index from the front of this workers deque. Returns false, if it's empty.
+		bool PopFront(uint32_t& jobIndex);
+
+		//! Will steal the last job index from the back of this workers deque. Called by all other threads. Returns false, if it's empty.
+		bool StealBack(uint32_t& jobIndex);
+
+		//! This workers deque of job indices [begin, end), packed into a single word as (begin << 32) | end.
+		//! Jobs never get pushed while they run, so popping and stealing are each a single compare-and-swap. No locks involved.
+		//! Aligned to its own cache line, as every other thread polls it when stealing.
+		alignas(64) std::atomic<uint64_t> deque {0};
 
 		std::thread* ownThread = nullptr;
-		WorkerTask* task = nullptr;
 		WorkerPool* pool;
-		bool isIdling = true;
-		bool doTask = false;
-		bool doStop = false;
+		std::size_t index;
+		std::atomic<bool> isIdling {true};
+		std::atomic<bool> doStop {false};
 
 		friend class WorkerPool;
 	};
@@ -79,7 +77,14 @@ namespace TorGL
 	*	2. Execute();
 	*	3. Tasks are done.
 	*
-	* This thread pool makes use of an `std::condition_variable`, meaning the threads are sleeping when there is no work to do.
+	* Alternatively, ParallelFor() runs a function over chunks of an index range, without allocating any tasks.
+	*
+	* Both split their work into one contiguous range per worker. Workers that run out of work steal from the back of the others ranges.
+	* The calling thread steals too, instead of just waiting. Idle threads spin for a bounded time, then sleep on an `std::condition_variable`.
+	*
+	* A pool can be shared by multiple renderers on multiple threads (see GetShared()). Their Execute() and ParallelFor() calls get run one after another.
+	* Queueing tasks is not thread-safe though, so shared pools should only be used via ParallelFor().
+	* Jobs must not call Execute() or ParallelFor() on their own pool.
 	*/
 	class WorkerPool
 	{
@@ -87,12 +92,22 @@ namespace TorGL
 		WorkerPool(std::size_t numWorkers);
 		~WorkerPool();
 
+		//! Will return a process-wide pool with one worker per hardware thread. It gets created on first use.
+		//! Using this instead of a pool per renderer avoids oversubscribing the cpu.
+		static WorkerPool& GetShared();
+
 		//! Will queue a task to be done
 		void QueueTask(WorkerTask* task);
 
 		//! Will compute all queued tasks and return when they are finished
 		void Execute();
 
+		//! Will split the index range [begin, end) into chunks of grain indices, and call function(chunkBegin, chunkEnd) once per chunk, in parallel.
+		//! Returns when all chunks are done. If grain is 0, a chunk size giving every thread a few chunks gets picked.
+		//! Unlike queueing WorkerTasks, this does not allocate anything, and the function does not get type-erased into an std::function.
+		template <typename Function>
+		void ParallelFor(std::size_t begin, std::size_t end, std::size_t grain, const Function& function);
+
 		//! Will return the amound of unassigned tasks
 		std::size_t GetQueueLength() const;
 
@@ -103,12 +118,79 @@ namespace TorGL
 		std::size_t GetNumActiveWorkers() const;
 
 	private:
+		//! Will hand out job indices [0, numJobs) to all workers, help running them, and return once all of them are done.
+		//! A job is either a queued WorkerTask, or a chunk of a ParallelFor() range.
+		void Dispatch(std::size_t numJobs);
+
+		//! Will run jobs until there are none left to take. First from the own deque (if called by a worker), then stolen from all others.
+		void RunJobs(Worker* self);
+
+		//! Will run a single job, and signal Dispatch() if it was the last one
+		void RunJob(uint32_t jobIndex);
+
+		//! Will call the function of the current ParallelFor() call. Stored as a plain function pointer to avoid type-erasure.
+		template <typename Function>
+		static void RangeTrampoline(const void* function, std::size_t begin, std::size_t end);
+
+		//! How often an idle thread polls for new work, before going to sleep
+		static constexpr std::size_t numSpins = 1024;
+
 		std::vector<Worker*> workers;
 		std::vector<WorkerTask*> taskQueue;
 
+		//! The range of the current ParallelFor() call. rangeTrampoline is nullptr, if queued tasks are being executed instead.
+		void (*rangeTrampoline)(const void* function, std::size_t begin, std::size_t end) = nullptr;
+		const void* rangeFunction = nullptr;
+		std::size_t rangeBegin = 0;
+		std::size_t rangeEnd = 0;
+		std::size_t rangeGrain = 1;
+
+		//! Number of jobs of the current Dispatch() call that have not finished yet
+		std::atomic<std::size_t> numPendingJobs {0};
+
+		//! Incremented by every Dispatch() call. Workers wake up when it changes.
+		std::atomic<uint64_t> generation {0};
+
+		//! Held by Execute() and ParallelFor(), so callers on different threads take turns using the workers
+		std::mutex dispatchMutex;
+
 		std::mutex mutex;
-		std::condition_variable conditional_lock;
+		std::condition_variable workAvailable;
+		std::condition_variable jobsFinished;
 
 		friend class Worker;
 	};
+
+	template <typename Function>
+	void WorkerPool::ParallelFor(std::size_t begin, std::size_t end, std::size_t grain, const Function& function)
+	{
+		if (begin >= end)
+			return;
+
+		// Give every thread (including the calling one) a few chunks to allow for stealing
+		if (grain == 0)
+			grain = std::max<std::size_t>(1, (end - begin) / ((workers.size() + 1) * 8));
+
+		std::unique_lock<std::mutex> lck(dispatchMutex);
+
+		rangeTrampoline = &WorkerPool::RangeTrampoline<Function>;
+		rangeFunction = &function;
+		rangeBegin = begin;
+		rangeEnd = end;
+		rangeGrain = grain;
+
+		Dispatch((end - begin + grain - 1) / grain);
+
+		rangeTrampoline = nullptr;
+		rangeFunction = nullptr;
+
+		return;
+	}
+
+	template <typename Function>
+	void WorkerPool::RangeTrampoline(const void* function, std::size_t begin, std::size_t end)
+	{
+		(*static_cast<const Function*>(function))(begin, end);
+		return;
+	}
 }
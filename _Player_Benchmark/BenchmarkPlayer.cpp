@@ -27,9 +27,11 @@ namespace {
     const std::string windowBaseTitle = "TornadoPlato Benchmark";
 }
 
-BenchmarkPlayer::BenchmarkPlayer(const Vector2i& resolution) :
+BenchmarkPlayer::BenchmarkPlayer(const Vector2i& resolution, TorGL::DRAW_MODE drawMode) :
 renderer(resolution, 0, 0.5)
 {
+    renderer.SetDrawMode(drawMode);
+
     // Init Plato and RenderWindow as SDL2 render window
     SDL2RenderWindow* sdl2RenderWindow = new SDL2RenderWindow(resolution, windowBaseTitle, renderer.GetPixelBuffer());
     sdl2RenderWindow->EnableMouseCameraControlMode();
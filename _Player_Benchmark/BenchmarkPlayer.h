@@ -11,7 +11,7 @@
 class BenchmarkPlayer
 {
     public:
-        BenchmarkPlayer(const Plato::Vector2i& resolution);
+        BenchmarkPlayer(const Plato::Vector2i& resolution, TorGL::DRAW_MODE drawMode = TorGL::DRAW_MODE::FORWARD);
         ~BenchmarkPlayer();
 
         // Run the main app
@@ -21,7 +21,7 @@ void CaveCamFlightScene::Setup()
     const std::string assetsDir = "../Scenes/CaveCamFlight/assets";
 
 	// Load mesh files
-	ResourceManager::LoadMeshFromObj("cave", assetsDir + "/cave.obj");
+	ResourceManager::LoadMeshFromObj("cave", assetsDir + "/cave.obj", false, true);
 	ResourceManager::LoadMeshFromObj("cones", assetsDir + "/cones.obj");
 	ResourceManager::LoadMeshFromObj("lamps", assetsDir + "/lamps.obj");
 	ResourceManager::LoadMeshFromObj("lamps-cable", assetsDir + "/lamp-cable.obj");
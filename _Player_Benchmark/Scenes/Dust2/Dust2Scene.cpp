@@ -23,7 +23,7 @@ void Dust2Scene::Setup()
 
     // Load Dust2 assets
     const std::string assetsDir = "../../Scenes/Fun/Dust2/assets";
-    Mesh* dust2Mesh = ResourceManager::LoadMeshFromObj("dust2", assetsDir+"/dust2.obj", true);
+    Mesh* dust2Mesh = ResourceManager::LoadMeshFromObj("dust2", assetsDir+"/dust2.obj", true, true);
 
     // Create the dust2 map world object
     WorldObject* dust2Wo = WorldObjectManager::NewWorldObject("dust2 map");
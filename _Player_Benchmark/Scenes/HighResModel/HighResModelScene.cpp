@@ -24,7 +24,7 @@ void HighResModelScene::Setup()
     const std::string assetsDir = "../Scenes/HighResModel/assets";
 
 	// Load mesh files
-	ResourceManager::LoadMeshFromObj("bk", assetsDir + "/bk.obj");
+	ResourceManager::LoadMeshFromObj("bk", assetsDir + "/bk.obj", false, false, false, 4);
 
 	// Load texture files
 	ResourceManager::LoadTextureFromBmp("bk", assetsDir + "/bk.bmp");
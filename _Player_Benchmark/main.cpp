@@ -1,10 +1,26 @@
 #include "BenchmarkPlayer.h"
+#include <cstring>
+#include <iostream>
 
 
 int main(int argc, char* argv[]) {
     const Vector2i resolution(800*2, 600*1.5);
 
-    BenchmarkPlayer player(resolution);
+    // Select the draw mode, to A/B them against each other
+    TorGL::DRAW_MODE drawMode = TorGL::DRAW_MODE::FORWARD;
+    for (int i = 1; i + 1 < argc; i++) {
+        if (std::strcmp(argv[i], "--draw-mode") != 0)
+            continue;
+
+        if (std::strcmp(argv[i + 1], "depth-prepass") == 0)
+            drawMode = TorGL::DRAW_MODE::DEPTH_PREPASS;
+        else if (std::strcmp(argv[i + 1], "visibility-buffer") == 0)
+            drawMode = TorGL::DRAW_MODE::VISIBILITY_BUFFER;
+        else if (std::strcmp(argv[i + 1], "forward") != 0)
+            std::cerr << "Unknown draw mode \"" << argv[i + 1] << "\". Using forward." << std::endl;
+    }
+
+    BenchmarkPlayer player(resolution, drawMode);
     player.Run();
 
     return 0;
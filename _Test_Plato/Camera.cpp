@@ -154,6 +154,30 @@ TEST_CASE(__FILE__"/First_Camera_Is_Main_Camera", "[Camera]")
     return;
 }
 
+// Tests that the world space to camera space matrix transforms points the same way WorldSpaceToCameraSpace() does
+TEST_CASE(__FILE__"/WorldSpaceToCameraSpaceMatrix_Matches_Point_Transform", "[Camera]")
+{
+    TEST_START
+
+    // Setup
+    Camera* cam = WorldObjectManager::NewWorldObject()->AddComponent<Camera>(DUMMY_CAM_ARGUMENTS);
+    cam->transform->SetPosition(Vector3d(12, -3, 7.5));
+    cam->transform->SetRotation(Quaternion(Vector3d(25, -60, 10)));
+
+    // Exercise
+    const Matrix4x4 m = cam->GetWorldSpaceToCameraSpaceMatrix();
+
+    // Verify
+    for (std::size_t i = 0; i < 100; i++)
+    {
+        const Vector3d p((rng() % 2000) / 10.0 - 100, (rng() % 2000) / 10.0 - 100, (rng() % 2000) / 10.0 - 100);
+        REQUIRE((p * m).Similar(cam->WorldSpaceToCameraSpace(p), 0.000001));
+    }
+
+    TEST_END
+    return;
+}
+
 #undef DUMMY_CAM_ARGUMENTS
 #undef TEST_START
 #undef TEST_START
@@ -51,7 +51,7 @@ private:
 		return;
 	}
 
-	friend class WorldObject;
+	friend class Plato::WorldObject;
 };
 
 // Tests that any component is enabled by default
@@ -0,0 +1,233 @@
+#include "../_TestingUtilities/Catch2.h"
+#include "../Plato/Mesh.h"
+#include <random>
+
+using namespace Plato;
+
+namespace {
+    static std::mt19937 rng = std::mt19937((std::random_device())());
+}
+
+// Tests that a mesh without vertices has no bounds
+TEST_CASE(__FILE__"/Empty_Mesh_Has_No_Bounds", "[Mesh]")
+{
+    // Setup
+    Mesh mesh;
+
+    // Exercise
+    mesh.RecalculateBounds();
+
+    // Verify
+    REQUIRE_FALSE(mesh.hasBounds);
+
+    return;
+}
+
+// Tests that the bounding box and sphere both enclose all vertices, and the box is tight
+TEST_CASE(__FILE__"/Bounds_Enclose_All_Vertices", "[Mesh]")
+{
+    // Run test 100 times
+    for (std::size_t i = 0; i < 100; i++)
+    {
+        // Setup
+        Mesh mesh;
+        for (std::size_t j = 0; j < 50; j++)
+            mesh.v_vertices.emplace_back(
+                (rng() % 2000) / 10.0 - 100,
+                (rng() % 2000) / 10.0 - 100,
+                (rng() % 2000) / 10.0 - 100
+            );
+
+        // Exercise
+        mesh.RecalculateBounds();
+
+        // Verify
+        REQUIRE(mesh.hasBounds);
+
+        bool touchesMin[3] = { false, false, false };
+        bool touchesMax[3] = { false, false, false };
+
+        for (const Vector3d& v : mesh.v_vertices)
+        {
+            REQUIRE(v.x >= mesh.boundsMin.x);
+            REQUIRE(v.y >= mesh.boundsMin.y);
+            REQUIRE(v.z >= mesh.boundsMin.z);
+            REQUIRE(v.x <= mesh.boundsMax.x);
+            REQUIRE(v.y <= mesh.boundsMax.y);
+            REQUIRE(v.z <= mesh.boundsMax.z);
+            REQUIRE((v - mesh.boundingSphereCenter).Magnitude() <= mesh.boundingSphereRadius + 0.000001);
+
+            touchesMin[0] |= v.x == mesh.boundsMin.x;
+            touchesMin[1] |= v.y == mesh.boundsMin.y;
+            touchesMin[2] |= v.z == mesh.boundsMin.z;
+            touchesMax[0] |= v.x == mesh.boundsMax.x;
+            touchesMax[1] |= v.y == mesh.boundsMax.y;
+            touchesMax[2] |= v.z == mesh.boundsMax.z;
+        }
+
+        for (std::size_t c = 0; c < 3; c++)
+        {
+            REQUIRE(touchesMin[c]);
+            REQUIRE(touchesMax[c]);
+        }
+    }
+
+    return;
+}
+
+// Tests that sorting by material keeps every triangles material, and results in one ascending range per material
+TEST_CASE(__FILE__"/SetTriangleMaterials_One_Range_Per_Material", "[Mesh]")
+{
+    Material materials[3];
+
+    // Run test 100 times
+    for (std::size_t i = 0; i < 100; i++)
+    {
+        // Setup
+        // Every triangle is identifiable by its first vertex index
+        Mesh mesh;
+        std::vector<const Material*> triangleMaterials;
+        for (std::uint32_t t = 0; t < 60; t++)
+        {
+            mesh.tris.push_back({ t, 0, 0 });
+            mesh.tris.push_back({ 0, 0, 0 });
+            mesh.tris.push_back({ 0, 0, 0 });
+
+            const std::size_t m = rng() % 4;
+            triangleMaterials.push_back((m < 3) ? &materials[m] : nullptr);
+        }
+
+        // Exercise
+        mesh.SetTriangleMaterials(triangleMaterials);
+
+        // Verify
+        const std::vector<const Material*> sortedMaterials = mesh.GetTriangleMaterials();
+        REQUIRE(sortedMaterials.size() == triangleMaterials.size());
+
+        for (std::size_t t = 0; t < sortedMaterials.size(); t++)
+        {
+            REQUIRE(sortedMaterials[t] == triangleMaterials[mesh.tris[t*3].v]);
+
+            // Triangles sharing a material keep their order
+            if ((t > 0) && (sortedMaterials[t] == sortedMaterials[t - 1]))
+                REQUIRE(mesh.tris[t*3].v > mesh.tris[(t - 1)*3].v);
+        }
+
+        std::size_t end = 0;
+        for (std::size_t s = 0; s < mesh.submeshes.size(); s++)
+        {
+            REQUIRE(mesh.submeshes[s].begin == end);
+            REQUIRE(mesh.submeshes[s].end > mesh.submeshes[s].begin);
+            end = mesh.submeshes[s].end;
+
+            for (std::size_t s2 = 0; s2 < s; s2++)
+                REQUIRE(mesh.submeshes[s2].material != mesh.submeshes[s].material);
+        }
+        REQUIRE(end == sortedMaterials.size());
+    }
+
+    return;
+}
+
+// Tests that unifying the vertex buffers keeps every corners position, uv and normal, and deduplicates them
+TEST_CASE(__FILE__"/UnifyVertices_Keeps_All_Corners", "[Mesh]")
+{
+    // Run test 100 times
+    for (std::size_t i = 0; i < 100; i++)
+    {
+        // Setup
+        // Few different values per buffer, so that many corners share a combination
+        Mesh mesh;
+        for (std::size_t j = 0; j < 10; j++)
+        {
+            mesh.v_vertices.emplace_back((double)(rng() % 100), (double)(rng() % 100), (double)(rng() % 100));
+            mesh.uv_vertices.emplace_back((rng() % 100) / 100.0, (rng() % 100) / 100.0);
+            mesh.normals.emplace_back((double)(rng() % 100), (double)(rng() % 100), (double)(rng() % 100));
+        }
+
+        for (std::size_t j = 0; j < 90; j++)
+            mesh.tris.push_back({ (std::uint32_t)(rng() % 10), (std::uint32_t)(rng() % 3), (std::uint32_t)(rng() % 10) });
+
+        const Mesh original = mesh;
+        const std::size_t numUniqueVertices = mesh.CountUniqueVertices();
+
+        // Exercise
+        mesh.UnifyVertices();
+
+        // Verify
+        REQUIRE(mesh.v_vertices.size() == numUniqueVertices);
+        REQUIRE(mesh.uv_vertices.size() == numUniqueVertices);
+        REQUIRE(mesh.normals.size() == numUniqueVertices);
+        REQUIRE(mesh.tris.size() == original.tris.size());
+
+        std::size_t numVerticesSeen = 0;
+        for (std::size_t c = 0; c < mesh.tris.size(); c++)
+        {
+            const MeshVertexIndices& corner = mesh.tris[c];
+            const MeshVertexIndices& originalCorner = original.tris[c];
+
+            REQUIRE(corner.v == corner.uv);
+            REQUIRE(corner.v == corner.vn);
+            REQUIRE(mesh.v_vertices[corner.v] == original.v_vertices[originalCorner.v]);
+            REQUIRE(mesh.uv_vertices[corner.uv] == original.uv_vertices[originalCorner.uv]);
+            REQUIRE(mesh.normals[corner.vn] == original.normals[originalCorner.vn]);
+
+            // Vertices are in the order of first use
+            REQUIRE(corner.v <= numVerticesSeen);
+            if (corner.v == numVerticesSeen)
+                numVerticesSeen++;
+        }
+    }
+
+    return;
+}
+
+// Tests that every modification gives a mesh a new version, and that no two meshes share one
+TEST_CASE(__FILE__"/Modifications_Change_Version", "[Mesh]")
+{
+    // Setup
+    Mesh mesh;
+    Mesh other;
+    mesh.v_vertices = { Vector3d(0, 0, 0), Vector3d(1, 0, 0), Vector3d(0, 1, 0) };
+    mesh.tris = { { 0, 0, 0 }, { 1, 0, 0 }, { 2, 0, 0 } };
+
+    // Exercise
+    const std::uint64_t initial = mesh.GetVersion();
+    mesh.MarkModified();
+    const std::uint64_t marked = mesh.GetVersion();
+    mesh.RecalculateBounds();
+    const std::uint64_t recalculated = mesh.GetVersion();
+    mesh.UnifyVertices();
+    const std::uint64_t unified = mesh.GetVersion();
+
+    // Verify
+    REQUIRE(initial != other.GetVersion());
+    REQUIRE(marked != initial);
+    REQUIRE(recalculated != marked);
+    REQUIRE(unified != recalculated);
+
+    return;
+}
+
+// Tests that copying a mesh, or assigning one, never results in two meshes with the same version
+TEST_CASE(__FILE__"/Copies_Get_Own_Version", "[Mesh]")
+{
+    // Setup
+    Mesh mesh;
+    Mesh assigned;
+    const std::uint64_t assignedBefore = assigned.GetVersion();
+
+    // Exercise
+    const Mesh copy(mesh);
+    assigned = mesh;
+    std::vector<Mesh> lods = { mesh, mesh };
+
+    // Verify
+    REQUIRE(copy.GetVersion() != mesh.GetVersion());
+    REQUIRE(assigned.GetVersion() != mesh.GetVersion());
+    REQUIRE(assigned.GetVersion() != assignedBefore);
+    REQUIRE(lods[0].GetVersion() != lods[1].GetVersion());
+    REQUIRE(lods[0].GetVersion() != mesh.GetVersion());
+
+    return;
+}
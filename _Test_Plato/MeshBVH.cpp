@@ -0,0 +1,119 @@
+#include "../_TestingUtilities/Catch2.h"
+#include "../Plato/Mesh.h"
+#include <random>
+#include <algorithm>
+
+using namespace Plato;
+
+namespace {
+    static std::mt19937 rng = std::mt19937((std::random_device())());
+
+    // Will create a mesh of random triangles
+    Mesh RandomMesh(std::size_t numTriangles)
+    {
+        Mesh mesh;
+        for (std::uint32_t i = 0; i < numTriangles * 3; i++)
+        {
+            mesh.v_vertices.emplace_back(
+                (rng() % 2000) / 10.0 - 100,
+                (rng() % 2000) / 10.0 - 100,
+                (rng() % 2000) / 10.0 - 100
+            );
+            mesh.tris.push_back({ i, 0, 0 });
+        }
+
+        return mesh;
+    }
+
+    bool IsInside(const Vector3d& v, const Vector3d& boundsMin, const Vector3d& boundsMax)
+    {
+        return
+            (v.x >= boundsMin.x) && (v.y >= boundsMin.y) && (v.z >= boundsMin.z) &&
+            (v.x <= boundsMax.x) && (v.y <= boundsMax.y) && (v.z <= boundsMax.z);
+    }
+}
+
+// Tests that building a bvh over a mesh without triangles results in an empty bvh
+TEST_CASE(__FILE__"/Empty_Mesh_Empty_BVH", "[MeshBVH]")
+{
+    // Setup
+    Mesh mesh;
+
+    // Exercise
+    mesh.BuildBVH();
+
+    // Verify
+    REQUIRE(mesh.bvh.Empty());
+
+    return;
+}
+
+// Tests that the bvh order is a permutation of the original triangles, with the vertex indices carried along
+TEST_CASE(__FILE__"/Triangle_Order_Is_A_Permutation", "[MeshBVH]")
+{
+    // Setup
+    Mesh mesh = RandomMesh(1000);
+
+    // Exercise
+    mesh.BuildBVH(16);
+
+    // Verify
+    const std::vector<std::size_t>& order = mesh.bvh.GetTriangleOrder();
+    const std::vector<MeshVertexIndices>& tris = mesh.bvh.GetTris();
+    REQUIRE(order.size() == 1000);
+    REQUIRE(tris.size() == mesh.tris.size());
+
+    std::vector<std::size_t> sorted = order;
+    std::sort(sorted.begin(), sorted.end());
+    for (std::size_t i = 0; i < sorted.size(); i++)
+        REQUIRE(sorted[i] == i);
+
+    for (std::size_t i = 0; i < order.size(); i++)
+        for (std::size_t j = 0; j < 3; j++)
+            REQUIRE(tris[i*3 + j].v == mesh.tris[order[i]*3 + j].v);
+
+    return;
+}
+
+// Tests that every node encloses its triangles, its children cover exactly its range, and leaves respect the size limit
+TEST_CASE(__FILE__"/Nodes_Enclose_Their_Triangles", "[MeshBVH]")
+{
+    // Setup
+    Mesh mesh = RandomMesh(1000);
+
+    // Exercise
+    mesh.BuildBVH(16);
+
+    // Verify
+    const std::vector<MeshBVH::Node>& nodes = mesh.bvh.GetNodes();
+    const std::vector<MeshVertexIndices>& tris = mesh.bvh.GetTris();
+
+    REQUIRE(nodes[0].begin == 0);
+    REQUIRE(nodes[0].end == 1000);
+    REQUIRE(nodes[0].skip == nodes.size());
+
+    for (std::size_t i = 0; i < nodes.size(); i++)
+    {
+        const MeshBVH::Node& node = nodes[i];
+
+        for (std::size_t t = node.begin * 3; t < node.end * 3; t++)
+            REQUIRE(IsInside(mesh.v_vertices[tris[t].v], node.boundsMin, node.boundsMax));
+
+        // Leaf
+        if (node.skip == i + 1)
+        {
+            REQUIRE(node.end - node.begin <= 16);
+            continue;
+        }
+
+        // Children have to be adjacent, and cover the parents range
+        const MeshBVH::Node& left = nodes[i + 1];
+        const MeshBVH::Node& right = nodes[left.skip];
+        REQUIRE(left.begin == node.begin);
+        REQUIRE(left.end == right.begin);
+        REQUIRE(right.end == node.end);
+        REQUIRE(right.skip == node.skip);
+    }
+
+    return;
+}
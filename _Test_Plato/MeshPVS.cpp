@@ -0,0 +1,225 @@
+#include "../_TestingUtilities/Catch2.h"
+#include "../Plato/Mesh.h"
+#include <cstdio>
+
+using namespace Plato;
+
+namespace {
+    // Will add a square quad of two triangles, facing along z
+    void AddQuad(Mesh& mesh, double halfSize, double z)
+    {
+        const std::uint32_t first = (std::uint32_t)mesh.v_vertices.size();
+        mesh.v_vertices.emplace_back(-halfSize, -halfSize, z);
+        mesh.v_vertices.emplace_back( halfSize, -halfSize, z);
+        mesh.v_vertices.emplace_back( halfSize,  halfSize, z);
+        mesh.v_vertices.emplace_back(-halfSize,  halfSize, z);
+
+        mesh.tris.push_back({ first,     0, 0 });
+        mesh.tris.push_back({ first + 1, 0, 0 });
+        mesh.tris.push_back({ first + 2, 0, 0 });
+        mesh.tris.push_back({ first,     0, 0 });
+        mesh.tris.push_back({ first + 2, 0, 0 });
+        mesh.tris.push_back({ first + 3, 0, 0 });
+
+        return;
+    }
+
+    // Two small quads, with a big wall in between them.
+    // Triangles 0 and 1 are in front of the wall, 2 and 3 are the wall, 4 and 5 are behind it.
+    Mesh WalledMesh()
+    {
+        Mesh mesh;
+        AddQuad(mesh, 1, -5);
+        AddQuad(mesh, 10, 0);
+        AddQuad(mesh, 1, 5);
+
+        // One triangle per leaf
+        mesh.BuildBVH(1);
+
+        return mesh;
+    }
+
+    // Will return the index of the leaf holding the original triangle t
+    std::size_t FindLeaf(const Mesh& mesh, std::size_t t)
+    {
+        const std::vector<MeshBVH::Node>& nodes = mesh.bvh.GetNodes();
+        for (std::size_t i = 0; i < nodes.size(); i++)
+            if ((nodes[i].skip == i + 1) && (mesh.bvh.GetTriangleOrder()[nodes[i].begin] == t))
+                return i;
+
+        return nodes.size();
+    }
+}
+
+// Tests that triangles hidden behind a wall are not in the visible set, while everything on the same side is
+TEST_CASE(__FILE__"/Wall_Hides_Triangles_Behind_It", "[MeshPVS]")
+{
+    // Setup
+    Mesh mesh = WalledMesh();
+
+    // Exercise
+    mesh.BuildPVS(TorGL::WorkerPool::GetShared());
+
+    // Verify
+    const std::uint8_t* visibleNodes = mesh.pvs.GetVisibleNodes(Vector3d(-0.5, 0.5, -4.5));
+    REQUIRE(visibleNodes != nullptr);
+
+    REQUIRE(visibleNodes[0]); // Root
+    REQUIRE(visibleNodes[FindLeaf(mesh, 0)]);
+    REQUIRE(visibleNodes[FindLeaf(mesh, 1)]);
+    REQUIRE(visibleNodes[FindLeaf(mesh, 2)]);
+    REQUIRE(visibleNodes[FindLeaf(mesh, 3)]);
+    REQUIRE_FALSE(visibleNodes[FindLeaf(mesh, 4)]);
+    REQUIRE_FALSE(visibleNodes[FindLeaf(mesh, 5)]);
+
+    return;
+}
+
+// Tests that points outside of the meshes bounds have no visible set
+TEST_CASE(__FILE__"/Outside_Of_Grid_Nullptr", "[MeshPVS]")
+{
+    // Setup
+    Mesh mesh = WalledMesh();
+
+    // Exercise
+    mesh.BuildPVS(TorGL::WorkerPool::GetShared());
+
+    // Verify
+    REQUIRE(mesh.pvs.GetVisibleNodes(Vector3d(0, 0, -6)) == nullptr);
+    REQUIRE(mesh.pvs.GetVisibleNodes(Vector3d(0, 11, 0)) == nullptr);
+
+    return;
+}
+
+// Tests that a saved pvs can be loaded again, but only for the same mesh
+TEST_CASE(__FILE__"/Cache_File_Roundtrip", "[MeshPVS]")
+{
+    // Setup
+    const std::string filename = "_test_meshpvs_cache.pvs";
+    Mesh mesh = WalledMesh();
+    mesh.BuildPVS(TorGL::WorkerPool::GetShared());
+    const std::uint64_t hash = MeshPVS::HashMesh(mesh.v_vertices, mesh.bvh);
+
+    // Exercise
+    REQUIRE(mesh.pvs.SaveToFile(filename, hash));
+
+    MeshPVS loaded;
+    const bool loadedSameMesh = loaded.LoadFromFile(filename, hash);
+
+    MeshPVS loadedOtherMesh;
+    const bool loadedOtherMeshSuccessfully = loadedOtherMesh.LoadFromFile(filename, hash + 1);
+
+    std::remove(filename.c_str());
+
+    // Verify
+    REQUIRE(loadedSameMesh);
+    REQUIRE_FALSE(loadedOtherMeshSuccessfully);
+    REQUIRE(loadedOtherMesh.Empty());
+
+    const std::size_t numNodes = mesh.bvh.GetNodes().size();
+    for (double z = -4.9; z < 5; z += 0.5)
+    {
+        const std::uint8_t* a = mesh.pvs.GetVisibleNodes(Vector3d(0.1, 0.1, z));
+        const std::uint8_t* b = loaded.GetVisibleNodes(Vector3d(0.1, 0.1, z));
+        REQUIRE(a != nullptr);
+        REQUIRE(b != nullptr);
+
+        for (std::size_t i = 0; i < numNodes; i++)
+            REQUIRE(a[i] == b[i]);
+    }
+
+    return;
+}
+
+// Tests that leaves close to a cell are visible from it, even if no ray got cast at all
+TEST_CASE(__FILE__"/Nearby_Leaves_Visible_Without_Rays", "[MeshPVS]")
+{
+    // Setup
+    Mesh mesh = WalledMesh();
+
+    // Exercise
+    mesh.BuildPVS(TorGL::WorkerPool::GetShared(), 16, 0);
+
+    // Verify
+    const std::uint8_t* visibleNodes = mesh.pvs.GetVisibleNodes(Vector3d(-0.5, 0.5, -4.5));
+    REQUIRE(visibleNodes != nullptr);
+
+    REQUIRE(visibleNodes[FindLeaf(mesh, 0)]);
+    REQUIRE(visibleNodes[FindLeaf(mesh, 1)]);
+    REQUIRE_FALSE(visibleNodes[FindLeaf(mesh, 4)]);
+    REQUIRE_FALSE(visibleNodes[FindLeaf(mesh, 5)]);
+
+    return;
+}
+
+// Tests that a cell also sees what its neighbouring cells see, even through the wall
+TEST_CASE(__FILE__"/Cells_See_What_Their_Neighbours_See", "[MeshPVS]")
+{
+    // Setup
+    Mesh mesh = WalledMesh();
+
+    // Exercise
+    mesh.BuildPVS(TorGL::WorkerPool::GetShared());
+
+    // Verify
+    // Cells are 1.25 units big. This one is right in front of the wall, its neighbour right behind it.
+    const std::uint8_t* inFrontOfWall = mesh.pvs.GetVisibleNodes(Vector3d(0.1, 0.1, -0.6));
+    REQUIRE(inFrontOfWall != nullptr);
+    REQUIRE(inFrontOfWall[FindLeaf(mesh, 4)]);
+    REQUIRE(inFrontOfWall[FindLeaf(mesh, 5)]);
+
+    // Two cells in front of the wall, no neighbour sees behind it
+    const std::uint8_t* twoCellsInFrontOfWall = mesh.pvs.GetVisibleNodes(Vector3d(0.1, 0.1, -1.9));
+    REQUIRE(twoCellsInFrontOfWall != nullptr);
+    REQUIRE_FALSE(twoCellsInFrontOfWall[FindLeaf(mesh, 4)]);
+    REQUIRE_FALSE(twoCellsInFrontOfWall[FindLeaf(mesh, 5)]);
+
+    return;
+}
+
+// Tests that the same mesh, with different build parameters, hashes differently
+TEST_CASE(__FILE__"/Hash_Includes_Build_Parameters", "[MeshPVS]")
+{
+    // Setup
+    Mesh mesh = WalledMesh();
+
+    // Exercise
+    const std::uint64_t hash = MeshPVS::HashMesh(mesh.v_vertices, mesh.bvh, 16, 32);
+    const std::uint64_t otherCells = MeshPVS::HashMesh(mesh.v_vertices, mesh.bvh, 8, 32);
+    const std::uint64_t otherRays = MeshPVS::HashMesh(mesh.v_vertices, mesh.bvh, 16, 64);
+
+    // Verify
+    REQUIRE(hash == MeshPVS::HashMesh(mesh.v_vertices, mesh.bvh, 16, 32));
+    REQUIRE(hash != otherCells);
+    REQUIRE(hash != otherRays);
+
+    return;
+}
+
+// Tests that building on a private worker pool results in the same visible sets as on the shared one
+TEST_CASE(__FILE__"/Same_Sets_On_Any_Worker_Pool", "[MeshPVS]")
+{
+    // Setup
+    TorGL::WorkerPool privatePool(2);
+    Mesh a = WalledMesh();
+    Mesh b = WalledMesh();
+
+    // Exercise
+    a.BuildPVS(TorGL::WorkerPool::GetShared());
+    b.BuildPVS(privatePool);
+
+    // Verify
+    const std::size_t numNodes = a.bvh.GetNodes().size();
+    for (double z = -4.9; z < 5; z += 0.5)
+    {
+        const std::uint8_t* visibleA = a.pvs.GetVisibleNodes(Vector3d(0.1, 0.1, z));
+        const std::uint8_t* visibleB = b.pvs.GetVisibleNodes(Vector3d(0.1, 0.1, z));
+        REQUIRE(visibleA != nullptr);
+        REQUIRE(visibleB != nullptr);
+
+        for (std::size_t i = 0; i < numNodes; i++)
+            REQUIRE(visibleA[i] == visibleB[i]);
+    }
+
+    return;
+}
@@ -0,0 +1,216 @@
+#include "../_TestingUtilities/Catch2.h"
+#include "../Plato/MeshSimplifier.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <map>
+#include <set>
+
+using namespace Plato;
+
+namespace {
+    // Will create a flat, square grid of size x size quads in the xy plane, with one uv per vertex
+    Mesh GridMesh(std::size_t size)
+    {
+        Mesh mesh;
+        mesh.normals.emplace_back(0, 0, 1);
+
+        for (std::size_t y = 0; y <= size; y++)
+            for (std::size_t x = 0; x <= size; x++)
+            {
+                mesh.v_vertices.emplace_back((double)x, (double)y, 0);
+                mesh.uv_vertices.emplace_back((double)x / size, (double)y / size);
+            }
+
+        for (std::size_t y = 0; y < size; y++)
+            for (std::size_t x = 0; x < size; x++)
+            {
+                const std::uint32_t i = (std::uint32_t)(y * (size + 1) + x);
+                const std::uint32_t quad[4] = { i, i + 1, i + (std::uint32_t)size + 2, i + (std::uint32_t)size + 1 };
+
+                for (const std::uint32_t c : { quad[0], quad[1], quad[2], quad[0], quad[2], quad[3] })
+                    mesh.tris.push_back({ c, c, 0 });
+            }
+
+        return mesh;
+    }
+
+    // Will create a closed sphere of radius 1, with rings x segments quads between its poles, and no seams
+    Mesh SphereMesh(std::size_t rings, std::size_t segments)
+    {
+        Mesh mesh;
+        mesh.uv_vertices.emplace_back(0, 0);
+        mesh.normals.emplace_back(0, 0, 1);
+
+        const double pi = 3.14159265358979323846;
+        mesh.v_vertices.emplace_back(0, 1, 0);
+        for (std::size_t r = 1; r < rings; r++)
+            for (std::size_t s = 0; s < segments; s++)
+            {
+                const double theta = pi * r / rings;
+                const double phi = 2 * pi * s / segments;
+                mesh.v_vertices.emplace_back(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+            }
+        mesh.v_vertices.emplace_back(0, -1, 0);
+
+        const std::uint32_t southPole = (std::uint32_t)mesh.v_vertices.size() - 1;
+        const auto Ring = [segments](std::size_t r, std::size_t s) { return (std::uint32_t)(1 + (r - 1) * segments + s % segments); };
+        const auto AddFace = [&mesh](std::uint32_t a, std::uint32_t b, std::uint32_t c)
+        {
+            for (const std::uint32_t v : { a, b, c })
+                mesh.tris.push_back({ v, 0, 0 });
+        };
+
+        for (std::size_t s = 0; s < segments; s++)
+        {
+            AddFace(0, Ring(1, s + 1), Ring(1, s));
+            AddFace(southPole, Ring(rings - 1, s), Ring(rings - 1, s + 1));
+
+            for (std::size_t r = 1; r < rings - 1; r++)
+            {
+                AddFace(Ring(r, s), Ring(r, s + 1), Ring(r + 1, s + 1));
+                AddFace(Ring(r, s), Ring(r + 1, s + 1), Ring(r + 1, s));
+            }
+        }
+
+        return mesh;
+    }
+
+    // Will return whether every edge of the mesh is shared by exactly two faces, and no two faces use the same vertices
+    bool IsClosedManifold(const Mesh& mesh)
+    {
+        std::map<std::pair<std::uint32_t, std::uint32_t>, std::size_t> edgeFaceCounts;
+        std::set<std::array<std::uint32_t, 3>> faces;
+
+        for (std::size_t i = 0; i < mesh.tris.size(); i += 3)
+        {
+            std::array<std::uint32_t, 3> face = { mesh.tris[i].v, mesh.tris[i + 1].v, mesh.tris[i + 2].v };
+
+            for (std::size_t c = 0; c < 3; c++)
+                edgeFaceCounts[std::minmax(face[c], face[(c + 1) % 3])]++;
+
+            std::sort(face.begin(), face.end());
+            if ((face[0] == face[1]) || (face[1] == face[2]) || (!faces.insert(face).second))
+                return false;
+        }
+
+        for (const auto& [edge, count] : edgeFaceCounts)
+            if (count != 2)
+                return false;
+
+        return true;
+    }
+}
+
+// Tests that every level of detail has noticeably less triangles than the one before
+TEST_CASE(__FILE__"/Lods_Get_Coarser", "[MeshSimplifier]")
+{
+    // Setup
+    const Mesh mesh = GridMesh(20);
+
+    // Exercise
+    const std::vector<Mesh> lods = MeshSimplifier::GenerateLods(mesh, 3, 0.5);
+
+    // Verify
+    REQUIRE(lods.size() == 3);
+
+    std::size_t previousNumTris = mesh.tris.size() / 3;
+    for (const Mesh& lod : lods)
+    {
+        REQUIRE(lod.tris.size() % 3 == 0);
+        REQUIRE(lod.tris.size() / 3 <= previousNumTris * 3 / 4);
+        REQUIRE(lod.hasBounds);
+        previousNumTris = lod.tris.size() / 3;
+    }
+
+    return;
+}
+
+// Tests that simplified meshes only use original vertices, with their original texture coordinates, and valid indices
+TEST_CASE(__FILE__"/Lods_Keep_Vertex_Attributes", "[MeshSimplifier]")
+{
+    // Setup
+    const Mesh mesh = GridMesh(20);
+
+    // Exercise
+    const std::vector<Mesh> lods = MeshSimplifier::GenerateLods(mesh, 3, 0.5);
+
+    // Verify
+    for (const Mesh& lod : lods)
+    {
+        for (const MeshVertexIndices& idx : lod.tris)
+        {
+            REQUIRE(idx.v < lod.v_vertices.size());
+            REQUIRE(idx.uv < lod.uv_vertices.size());
+            REQUIRE(idx.vn < lod.normals.size());
+
+            // Texture coordinates stay attached to their vertex
+            const Vector3d& v = lod.v_vertices[idx.v];
+            const Vector2d& uv = lod.uv_vertices[idx.uv];
+            REQUIRE(uv.x == Approx(v.x / 20));
+            REQUIRE(uv.y == Approx(v.y / 20));
+        }
+    }
+
+    return;
+}
+
+// Tests that the open border of a mesh does not shrink
+TEST_CASE(__FILE__"/Lods_Keep_Borders", "[MeshSimplifier]")
+{
+    // Setup
+    const Mesh mesh = GridMesh(20);
+
+    // Exercise
+    const std::vector<Mesh> lods = MeshSimplifier::GenerateLods(mesh, 3, 0.5);
+
+    // Verify
+    for (const Mesh& lod : lods)
+    {
+        REQUIRE(lod.boundsMin.x == 0);
+        REQUIRE(lod.boundsMin.y == 0);
+        REQUIRE(lod.boundsMax.x == 20);
+        REQUIRE(lod.boundsMax.y == 20);
+
+        // All faces still face the same way
+        for (std::size_t i = 0; i < lod.tris.size(); i += 3)
+        {
+            const Vector3d& a = lod.v_vertices[lod.tris[i].v];
+            const Vector3d& b = lod.v_vertices[lod.tris[i + 1].v];
+            const Vector3d& c = lod.v_vertices[lod.tris[i + 2].v];
+            REQUIRE((b - a).CrossProduct(c - a).z > 0);
+        }
+    }
+
+    return;
+}
+
+// Tests that collapses never pinch a closed surface into non-manifold fins, or duplicate faces
+TEST_CASE(__FILE__"/Lods_Stay_Manifold", "[MeshSimplifier]")
+{
+    // Setup
+    Mesh tetrahedron;
+    tetrahedron.uv_vertices.emplace_back(0, 0);
+    tetrahedron.normals.emplace_back(0, 0, 1);
+    tetrahedron.v_vertices = { Vector3d(1, 1, 1), Vector3d(1, -1, -1), Vector3d(-1, 1, -1), Vector3d(-1, -1, 1) };
+    for (const std::uint32_t v : { 0, 1, 2, 0, 3, 1, 0, 2, 3, 1, 3, 2 })
+        tetrahedron.tris.push_back({ v, 0, 0 });
+
+    const Mesh sphere = SphereMesh(8, 12);
+    REQUIRE(IsClosedManifold(tetrahedron));
+    REQUIRE(IsClosedManifold(sphere));
+
+    // Exercise
+    const std::vector<Mesh> tetrahedronLods = MeshSimplifier::GenerateLods(tetrahedron, 3, 0.5);
+    const std::vector<Mesh> sphereLods = MeshSimplifier::GenerateLods(sphere, 8, 0.5);
+
+    // Verify
+    // Nothing to collapse in a tetrahedron, without folding it flat
+    REQUIRE(tetrahedronLods.empty());
+
+    REQUIRE_FALSE(sphereLods.empty());
+    for (const Mesh& lod : sphereLods)
+        REQUIRE(IsClosedManifold(lod));
+
+    return;
+}
@@ -343,5 +343,38 @@ TEST_CASE(__FILE__"/Recalculating_GlobalTransformCache_Always_Yields_Same_Result
     return;
 }
 
+// Tests that the global transform version changes with the transform, and its parents, but not when reading
+TEST_CASE(__FILE__"/GlobalTransformVersion_Changes_With_Parent", "[Transform]")
+{
+    // Free any rubbish previously failed tests left behind
+    WorldObjectManager::Free();
+
+    // Setup
+    Transform* parent = NEW_TRANSFORM;
+    Transform* child = NEW_TRANSFORM;
+    Transform* other = NEW_TRANSFORM;
+    child->SetParent(parent);
+
+    REQUIRE(parent->GetGlobalTransformVersion() != child->GetGlobalTransformVersion());
+    REQUIRE(child->GetGlobalTransformVersion() != other->GetGlobalTransformVersion());
+
+    // Exercise
+    const std::uint64_t childVersion = child->GetGlobalTransformVersion();
+    child->GetGlobalTransformationMatrix();
+    const std::uint64_t childVersionAfterReading = child->GetGlobalTransformVersion();
+
+    const std::uint64_t otherVersion = other->GetGlobalTransformVersion();
+    parent->Move(Vector3d(1, 2, 3));
+    const std::uint64_t childVersionAfterMoving = child->GetGlobalTransformVersion();
+
+    // Verify
+    REQUIRE(childVersionAfterReading == childVersion);
+    REQUIRE(childVersionAfterMoving != childVersion);
+    REQUIRE(other->GetGlobalTransformVersion() == otherVersion);
+
+    WorldObjectManager::Free();
+    return;
+}
+
 #undef NEW_TRANSFORM
 
@@ -25,7 +25,7 @@ private:
 		return;
 	}
 
-	friend class WorldObject;
+	friend class Plato::WorldObject;
 };
 
 // Tests that a name can be set
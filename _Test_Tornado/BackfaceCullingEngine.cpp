@@ -2,6 +2,7 @@
 #include "../Tornado/BackfaceCullingEngine.h"
 #include <random>
 #include <sstream>
+#include <cmath>
 
 using namespace TorGL;
 
@@ -63,3 +64,57 @@ TEST_CASE(__FILE__"/Does_Clip_Completely_Backfacing_Triangle", "[BackfaceCulling
     return;
 }
 
+// Tests that the clipping space test agrees with culling after the perspective divide
+TEST_CASE(__FILE__"/IsFrontFacing_Agrees_With_Cull", "[BackfaceCullingEngine]")
+{
+    // Setup
+    WorkerPool wp(0);
+    BackfaceCullingEngine cullingEngine(&wp);
+
+    // Run test 1000 times
+    for (std::size_t i = 0; i < 1000; i++)
+    {
+        InterRenderTriangle ird;
+        #define rnddnum ((double)(rng() % 1000) - 500)
+        ird.a.pos_cs = Vector4d(rnddnum, rnddnum, rnddnum, rng() % 500 + 1.0);
+        ird.b.pos_cs = Vector4d(rnddnum, rnddnum, rnddnum, rng() % 500 + 1.0);
+        ird.c.pos_cs = Vector4d(rnddnum, rnddnum, rnddnum, rng() % 500 + 1.0);
+        #undef rnddnum
+
+        ird.a.pos_ndc = ird.a.pos_cs / ird.a.pos_cs.w;
+        ird.b.pos_ndc = ird.b.pos_cs / ird.b.pos_cs.w;
+        ird.c.pos_ndc = ird.c.pos_cs / ird.c.pos_cs.w;
+
+        // Skip (nearly) degenerate triangles. Cull() keeps those, and rounding could go either way.
+        const double ndcArea = (ird.b.pos_ndc - ird.a.pos_ndc).CrossProduct(ird.c.pos_ndc - ird.a.pos_ndc).z;
+        if (std::abs(ndcArea) < 0.000001)
+            continue;
+
+        // Exercise
+        std::vector<InterRenderTriangle> tris;
+        tris.push_back(ird);
+
+        cullingEngine.BeginBatch();
+        cullingEngine.RegisterInterRenderTriangle(&tris[0]);
+        cullingEngine.Cull();
+        const bool isKeptByCull = cullingEngine.Finish().size() == 1;
+
+        // Verify
+        REQUIRE(isKeptByCull == BackfaceCullingEngine::IsFrontFacing(ird.a.pos_cs, ird.b.pos_cs, ird.c.pos_cs));
+    }
+
+    return;
+}
+
+// Tests that triangles without any area do not face the camera
+TEST_CASE(__FILE__"/IsFrontFacing_Rejects_Zero_Area_Triangle", "[BackfaceCullingEngine]")
+{
+    const Vector4d a(0, 0, 1, 1);
+    const Vector4d b(1, 1, 1, 1);
+    const Vector4d c(2, 2, 1, 1);
+
+    REQUIRE_FALSE(BackfaceCullingEngine::IsFrontFacing(a, b, c));
+    REQUIRE_FALSE(BackfaceCullingEngine::IsFrontFacing(a, a, a));
+
+    return;
+}
@@ -196,6 +196,88 @@ TEST_CASE(__FILE__"/RandomClip_No_Vertex_Outside_Clipping_Space", "[ClippingEngi
     return;
 }
 
+// Tests that clipping into a ClippingResult yields the same triangles, in the same order, as clipping into a vector
+TEST_CASE(__FILE__"/ClippingResult_Matches_Vector_Result", "[ClippingEngine]")
+{
+    ClippingResult result;
+
+    // Run test 100 times, reusing the same result
+    for (std::size_t i = 0; i < 100; i++)
+    {
+        InterRenderTriangle ird;
+        #define rnddnum rng() % 1000
+        ird.a.pos_cs = Vector4d(rnddnum - 500, rnddnum - 500, rnddnum - 500, rng() % 500 + 25.0);
+        ird.b.pos_cs = Vector4d(rnddnum - 500, rnddnum - 500, rnddnum - 500, rng() % 500 + 25.0);
+        ird.c.pos_cs = Vector4d(rnddnum - 500, rnddnum - 500, rnddnum - 500, rng() % 500 + 25.0);
+        #undef rnddnum
+
+        ClippingEngine::Clip(ird, result);
+        const std::vector<InterRenderTriangle> ret = ClippingEngine::Clip(ird);
+
+        REQUIRE(ret.size() == result.Size());
+        REQUIRE(result.Size() <= ClippingResult::capacity);
+
+        for (std::size_t t = 0; t < ret.size(); t++)
+        {
+            REQUIRE(result[t].a.pos_cs == ret[t].a.pos_cs);
+            REQUIRE(result[t].b.pos_cs == ret[t].b.pos_cs);
+            REQUIRE(result[t].c.pos_cs == ret[t].c.pos_cs);
+        }
+    }
+
+    return;
+}
+
+// Tests that a triangle crossing a screen edge, but staying inside the guard band, is passed through unsplit
+TEST_CASE(__FILE__"/GuardBand_Does_Not_Split_Triangle_Crossing_Screen_Edge", "[ClippingEngine]")
+{
+    // Vertex b is outside the right screen edge (x > w), but within a guard band of 4 (x < 4w)
+    InterRenderTriangle ird;
+    ird.a.pos_cs = { 0, 0, 1, 10 };
+    ird.b.pos_cs = { 25, 0, 1, 10 };
+    ird.c.pos_cs = { 0, 5, 1, 10 };
+
+    // Without guard band, it gets split
+    REQUIRE(ClippingEngine::Clip(ird).size() > 1);
+
+    // With guard band, it stays as is
+    std::vector<InterRenderTriangle> ret = ClippingEngine::Clip(ird, 4.0);
+
+    REQUIRE(1 == ret.size());
+    REQUIRE(ret[0].a.pos_cs == ird.a.pos_cs);
+    REQUIRE(ret[0].b.pos_cs == ird.b.pos_cs);
+    REQUIRE(ret[0].c.pos_cs == ird.c.pos_cs);
+
+    return;
+}
+
+// Tests that the guard band does not apply to the near plane, and does not keep triangles that are completely off screen
+TEST_CASE(__FILE__"/GuardBand_Still_Clips_Near_And_Drops_Offscreen", "[ClippingEngine]")
+{
+    // Vertex b is behind the near plane
+    InterRenderTriangle nearTri;
+    nearTri.a.pos_cs = { 0, 0, 1, 10 };
+    nearTri.b.pos_cs = { 5, 0, -1, 10 };
+    nearTri.c.pos_cs = { 0, 5, 1, 10 };
+
+    for (const InterRenderTriangle& ir : ClippingEngine::Clip(nearTri, 4.0))
+    {
+        REQUIRE(ir.a.pos_cs.z >= -0.00001);
+        REQUIRE(ir.b.pos_cs.z >= -0.00001);
+        REQUIRE(ir.c.pos_cs.z >= -0.00001);
+    }
+
+    // All vertices are right of the screen, but inside the guard band
+    InterRenderTriangle offscreenTri;
+    offscreenTri.a.pos_cs = { 15, 0, 1, 10 };
+    offscreenTri.b.pos_cs = { 25, 0, 1, 10 };
+    offscreenTri.c.pos_cs = { 15, 5, 1, 10 };
+
+    REQUIRE(ClippingEngine::Clip(offscreenTri, 4.0).empty());
+
+    return;
+}
+
 // Tests that if only the A vertex is inside, the vertex order will stay intact
 TEST_CASE(__FILE__"/Vertex_Order_Stays_Intact_1_In_A", "[ClippingEngine]")
 {
@@ -321,3 +403,32 @@ TEST_CASE(__FILE__"/Vertex_Order_Stays_Intact_2_In_CA", "[ClippingEngine]")
 
     return;
 }
+
+// Tests that points spread across different outer planes do not count as outside, while points all outside of one plane do
+TEST_CASE(__FILE__"/IsOutsideFrustum_Needs_All_Points_Outside_The_Same_Plane", "[ClippingEngine]")
+{
+    // All left of the left plane
+    const Vector4d allLeft[] = {
+        { -20, 0, 4, 10 },
+        { -15, 30, 4, 10 },
+        { -11, -30, 4, 10 }
+    };
+
+    // One left of the left plane, one right of the right plane. The volume spanned still covers the screen.
+    const Vector4d leftAndRight[] = {
+        { -20, 0, 4, 10 },
+        { 20, 0, 4, 10 }
+    };
+
+    // One of them is inside
+    const Vector4d oneInside[] = {
+        { -20, 0, 4, 10 },
+        { 0, 0, 4, 10 }
+    };
+
+    REQUIRE(ClippingEngine::IsOutsideFrustum(allLeft, 3));
+    REQUIRE_FALSE(ClippingEngine::IsOutsideFrustum(leftAndRight, 2));
+    REQUIRE_FALSE(ClippingEngine::IsOutsideFrustum(oneInside, 2));
+
+    return;
+}
@@ -0,0 +1,31 @@
+#include "../_TestingUtilities/Catch2.h"
+#include "../Tornado/RenderPointLight.h"
+#include <limits>
+
+using namespace TorGL;
+
+// Tests that nothing beyond the range of a point light gets lit
+TEST_CASE(__FILE__"/Nothing_Lit_Beyond_Range", "[RenderPointLight]")
+{
+    // Setup
+    RenderPointLight light;
+    light.SetColor(Color::white);
+    light.SetIntensity(3);
+    light.SetPosition(Vector3d(0, 0, 0));
+
+    const double range = light.GetRange();
+    REQUIRE(range > 0);
+    REQUIRE(range < std::numeric_limits<double>::infinity());
+
+    // Exercise
+    const Color justInside = light.GetColorIntensityFactors(nullptr, Vector3d(0, range * 0.99, 0), Vector3d(0, -1, 0));
+    const Color atRange = light.GetColorIntensityFactors(nullptr, Vector3d(0, range, 0), Vector3d(0, -1, 0));
+    const Color beyondRange = light.GetColorIntensityFactors(nullptr, Vector3d(0, range * 1.01, 0), Vector3d(0, -1, 0));
+
+    // Verify
+    REQUIRE(justInside.r > 0);
+    REQUIRE(atRange.r == 0);
+    REQUIRE(beyondRange.r == 0);
+
+    return;
+}
@@ -3,7 +3,10 @@
 #include <random>
 #include <chrono>
 #include <cmath>
+#include <cstring>
 #include <thread>
+#include <vector>
+#include <algorithm>
 
 namespace {
     static std::mt19937 rng = std::mt19937((std::random_device())());
@@ -101,6 +104,75 @@ TEST_CASE("_WorkerPool Tests", "[multithreading]") {
         delete[] pixels;
     }
 
+    SECTION("ParallelFor_Visits_Every_Index_Exactly_Once") {
+        constexpr std::size_t numThreads = 8;
+        constexpr std::size_t numPixels = 512 * 512 + 7; // Not a multiple of any grain
+        uint8_t* pixels = new uint8_t[numPixels];
+        memset(pixels, 0, numPixels);
+
+        WorkerPool pool(numThreads);
+
+        // Automatic grain, a tiny one, and one larger than the range
+        for (const std::size_t grain : { std::size_t(0), std::size_t(3), numPixels * 2 }) {
+            pool.ParallelFor(0, numPixels, grain, [pixels](std::size_t begin, std::size_t end) {
+                for (std::size_t i = begin; i < end; i++)
+                    pixels[i]++;
+            });
+        }
+
+        for (std::size_t i = 0; i < numPixels; i++) {
+            REQUIRE(pixels[i] == 3);
+        }
+
+        delete[] pixels;
+    }
+
+    SECTION("Shared_Pool_Is_Process_Wide") {
+        WorkerPool& shared = WorkerPool::GetShared();
+        REQUIRE(&shared == &WorkerPool::GetShared());
+        REQUIRE(shared.GetNumWorkers() == std::max(1u, std::thread::hardware_concurrency()));
+    }
+
+    SECTION("Shared_Pool_Handles_Concurrent_Callers") {
+        constexpr std::size_t numCallers = 4;
+        constexpr std::size_t numPixels = 64 * 1024;
+        std::vector<uint8_t> pixels[numCallers];
+
+        // Every caller fills its own buffer, using the same pool at the same time
+        std::vector<std::thread> callers;
+        for (std::size_t c = 0; c < numCallers; c++) {
+            callers.emplace_back([&pixels, c]() {
+                pixels[c].resize(numPixels, 0);
+                for (std::size_t frame = 0; frame < 16; frame++) {
+                    WorkerPool::GetShared().ParallelFor(0, numPixels, 0, [&pixels, c](std::size_t begin, std::size_t end) {
+                        for (std::size_t i = begin; i < end; i++)
+                            pixels[c][i]++;
+                    });
+                }
+            });
+        }
+
+        for (std::thread& t : callers)
+            t.join();
+
+        for (std::size_t c = 0; c < numCallers; c++) {
+            for (std::size_t i = 0; i < numPixels; i++) {
+                REQUIRE(pixels[c][i] == 16);
+            }
+        }
+    }
+
+    SECTION("ParallelFor_Empty_Range_Does_Nothing") {
+        WorkerPool pool(4);
+        bool wasCalled = false;
+
+        pool.ParallelFor(10, 10, 0, [&wasCalled](std::size_t, std::size_t) {
+            wasCalled = true;
+        });
+
+        REQUIRE_FALSE(wasCalled);
+    }
+
     SECTION("Is_Faster_Than_Without") {
         constexpr std::size_t numPixels = 4096 * 4096;
         uint8_t* pixels = new uint8_t[numPixels];